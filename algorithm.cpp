@@ -1,6 +1,9 @@
 #include "algorithm.hpp"
+#include "search.hpp"
 
+#include <limits>
 #include <memory>
+#include <numeric>
 
 void greedyEdgeRotation(Graph& graph) {
     int rotations = 0;
@@ -17,53 +20,30 @@ void greedyEdgeRotation(Graph& graph) {
     cout << "Total: " << rotations << " rotations." << endl;
 }
 
-unique_ptr<Graph> randomGraphPtr(unsigned int size) {
+unique_ptr<Graph> randomGraphPtr(unsigned int size, RandomStream& random) {
     vector<vector<short>> adjacencyMatrix(size, vector<short>(size, 0));
 
     for (int i = 0; i < size; i++) {
-        for (int j = 0; j < i; j++) {
-            auto randomNum = (short) (rand() % 2);
-            adjacencyMatrix[i][j] = adjacencyMatrix[j][i] = randomNum;
+        for (int j = 0; j < i; j += 64) {
+            uint64_t edges = random();
+
+            for (int k = j; k < min(i, j + 64); k++) {
+                adjacencyMatrix[i][k] = adjacencyMatrix[k][i] = (short) (edges >> (k - j) & 1);
+            }
         }
     }
 
     return make_unique<Graph>(adjacencyMatrix);
 }
 
-unique_ptr<Partition> randomGraphPartitionPtr(unsigned int graphSize) {
-    return make_unique<Partition>(Partition::from(*randomGraphPtr(graphSize)));
+// Degrees of a random graph with the distribution of randomGraphPtr, without the adjacency matrix
+unique_ptr<Partition> randomGraphPartitionPtr(unsigned int graphSize, RandomStream& random) {
+    return make_unique<Partition>(GraphDegreeSampler(graphSize, 0.5).sample(random));
 }
 
-unique_ptr<Partition> randomPartitionPtr(unsigned int sum){
-    auto length = (unsigned int) (sqrt(2 * sum) + 1);
-    vector<vector<short>> matrix(length, vector<short>(length, 0));
-
-    while (sum > 0) {
-        int randX = rand() % length;
-        int randY = rand() % length;
-
-        if (matrix[randX][randY] == 0) {
-            matrix[randX][randY] = 1;
-            sum--;
-        }
-    }
-
-    for (int i = 0; i < length; i++) {
-        for (int j = 1; j < length; j++) {
-            matrix[i][0] += matrix[i][j];
-        }
-    }
-
-    vector<unsigned int> accumulated;
-    accumulated.reserve(length);
-
-    for (int i = 0; i < length; i++) {
-        accumulated.push_back(matrix[i][0]);
-    }
-
-    sort(accumulated.begin(), accumulated.end(), greater<unsigned int>());
-
-    return make_unique<Partition>(accumulated);
+// Uniform over the partitions of the sum
+unique_ptr<Partition> randomPartitionPtr(unsigned int sum, RandomStream& random) {
+    return make_unique<Partition>(PartitionSampler(sum).sample(random));
 }
 
 // Uses non-basic block movements, take care
@@ -275,39 +255,110 @@ void partitionBasicGraphicalAscendants(const Partition& partition, vector<Partit
     }
 }
 
-unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& startPartition) {
-    deque<Partition> queue({startPartition});
-    unordered_set<Partition> visited;
+// Inverse of partitionGraphicalAscendants: every graphical partition this one is a graphical ascendant of
+void partitionGraphicalDescendants(const Partition& partition, vector<Partition>& output) {
+    unsigned int length = partition.length();
+
+    for (int i = 0; i < length; i++) {
+        for (int j = i + 1; j <= length; j++) {
+            Partition child(partition);
+            child.move(i, j);
+
+            if (child.isValid() && child.isInsertable(i) && child.isRemovable(j) && child.isGraphical()) {
+                output.push_back(child);
+            }
+        }
+    }
+}
+
+// Every move changes the head or the tail sum by at most one block,
+// so at least half of the head/tail gap has to be moved before they coincide.
+unsigned int maximizingMovesLowerBound(const Partition& partition) {
+    unsigned int rank = partition.rank();
+    unsigned int headColumnsSum = 0;
+
+    for (int i = 0; i < rank; i++) {
+        headColumnsSum += partition[i];
+    }
+
+    unsigned int headSum = headColumnsSum - rank * (rank - 1);
+    unsigned int tailSum = partition.sum() - headColumnsSum;
+
+    return tailSum > headSum ? (tailSum - headSum) / 2 : 0;
+}
+
+static unique_ptr<deque<Partition>> restoreChainPtr(
+        const unordered_map<Partition, Partition>& parent,
+        Partition partition,
+        const Partition& startPartition
+) {
+    unique_ptr<deque<Partition>> result(new deque<Partition>({partition}));
+
+    while (partition != startPartition) {
+        partition = parent.at(partition);
+        result->push_front(partition);
+    }
+
+    return result;
+}
+
+static unique_ptr<deque<Partition>> findShortestMaximizingChainAStarPtr(const Partition& startPartition) {
+    // (estimate, -distance, order): the deepest of the equally promising partitions is expanded first
+    typedef tuple<unsigned int, int, unsigned long> Priority;
+    priority_queue<pair<Priority, Partition>, vector<pair<Priority, Partition>>, greater<pair<Priority, Partition>>> queue;
+    unordered_map<Partition, int> distance({{startPartition, 0}});
     unordered_map<Partition, Partition> parent;
+    unordered_set<Partition> visited;
+    unsigned long order = 0;
 
-    while (!queue.empty()) {
-        Partition partition = queue.front();
-        queue.pop_front();
+    queue.push({Priority(maximizingMovesLowerBound(startPartition), 0, order++), startPartition});
 
-        if (partition.isMaximumGraphical()) {
-            unique_ptr<deque<Partition>> result(new deque<Partition>({partition}));
+    while (!queue.empty()) {
+        Partition partition = queue.top().second;
+        queue.pop();
 
-            while (partition != startPartition) {
-                result->push_front((Partition&&) parent.at(partition));
-                partition = parent.at(partition);
-            }
+        if (!visited.insert(partition).second) {
+            continue;
+        }
 
-            return result;
+        if (partition.isMaximumGraphical()) {
+            return restoreChainPtr(parent, partition, startPartition);
         }
 
+        int childDistance = distance.at(partition) + 1;
         vector<Partition> graphicalAscendants;
         partitionGraphicalAscendants(partition, graphicalAscendants);
 
         for (const auto& child: graphicalAscendants) {
-            if (visited.count(child) > 0) {
+            auto known = distance.find(child);
+
+            if (known != distance.end() && known->second <= childDistance) {
                 continue;
             }
 
-            queue.push_back(child);
+            distance[child] = childDistance;
+            parent.erase(child);
             parent.insert({child, partition});
+            queue.push({Priority(childDistance + maximizingMovesLowerBound(child), -childDistance, order++), child});
         }
+    }
 
-        visited.insert(partition);
+    stringstream message;
+    message << "Invalid state: didn't find maximum graphical partition from '" << startPartition << "'.";
+    throw runtime_error(message.str());
+}
+
+unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& startPartition, ChainSearchMode mode) {
+    if (mode == A_STAR) {
+        return findShortestMaximizingChainAStarPtr(startPartition);
+    }
+
+    ThreadPool pool(1);
+    ParentRecorder recorder;
+    levelSearch<GraphicalAscendants, MaximumGraphicalGoal<true>>(startPartition, pool, recorder);
+
+    if (recorder.goalPtr != nullptr) {
+        return restoreChainPtr(recorder.parent, *recorder.goalPtr, startPartition);
     }
 
     stringstream message;
@@ -315,73 +366,299 @@ unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& sta
     throw runtime_error(message.str());
 }
 
-unique_ptr<unordered_set<Partition>> findMaximumGraphicalPartitionsPtr(const Partition& startPartition) {
-    deque<Partition> queue({startPartition});
+// Bidirectional BFS: graphical ascendants from the start and graphical descendants from the targets,
+// always expanding the smaller frontier by a whole level and stopping at the level where they meet.
+unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(
+        const Partition& startPartition,
+        const unordered_set<Partition>& targetPartitions
+) {
+    unordered_map<Partition, Partition> forwardParent;
+    unordered_map<Partition, Partition> backwardParent;
+    unordered_map<Partition, int> forwardDistance({{startPartition, 0}});
+    unordered_map<Partition, int> backwardDistance;
+    vector<Partition> forwardFrontier({startPartition});
+    vector<Partition> backwardFrontier(targetPartitions.begin(), targetPartitions.end());
+
+    for (const auto& target: targetPartitions) {
+        backwardDistance.insert({target, 0});
+    }
+
+    unique_ptr<Partition> meetingPtr;
+    int bestLength = 0;
+
+    if (targetPartitions.count(startPartition) > 0) {
+        meetingPtr.reset(new Partition(startPartition));
+    }
+
+    while (meetingPtr == nullptr && !forwardFrontier.empty() && !backwardFrontier.empty()) {
+        bool isForward = forwardFrontier.size() <= backwardFrontier.size();
+        vector<Partition>& frontier = isForward ? forwardFrontier : backwardFrontier;
+        unordered_map<Partition, Partition>& parent = isForward ? forwardParent : backwardParent;
+        unordered_map<Partition, int>& distance = isForward ? forwardDistance : backwardDistance;
+        unordered_map<Partition, int>& otherDistance = isForward ? backwardDistance : forwardDistance;
+        vector<Partition> nextFrontier;
+        vector<Partition> neighbours;
+
+        for (const auto& partition: frontier) {
+            int childDistance = distance.at(partition) + 1;
+            neighbours.clear();
+
+            if (isForward) {
+                partitionGraphicalAscendants(partition, neighbours);
+            }
+            else {
+                partitionGraphicalDescendants(partition, neighbours);
+            }
+
+            for (const auto& child: neighbours) {
+                if (!distance.insert({child, childDistance}).second) {
+                    continue;
+                }
+
+                parent.insert({child, partition});
+                nextFrontier.push_back(child);
+                auto other = otherDistance.find(child);
+
+                if (other != otherDistance.end() && (meetingPtr == nullptr || childDistance + other->second < bestLength)) {
+                    meetingPtr.reset(new Partition(child));
+                    bestLength = childDistance + other->second;
+                }
+            }
+        }
+
+        frontier.swap(nextFrontier);
+    }
+
+    if (meetingPtr == nullptr) {
+        stringstream message;
+        message << "Invalid state: didn't find target partition from '" << startPartition << "'.";
+        throw runtime_error(message.str());
+    }
+
+    unique_ptr<deque<Partition>> result = restoreChainPtr(forwardParent, *meetingPtr, startPartition);
+    Partition partition = *meetingPtr;
+
+    while (targetPartitions.count(partition) == 0) {
+        partition = backwardParent.at(partition);
+        result->push_back(partition);
+    }
+
+    return result;
+}
+
+// Only the set of reachable maximum graphical partitions matters, not the distances,
+// so the lattice is explored depth first by work-stealing workers sharing a lock-free visited set.
+unique_ptr<unordered_set<Partition>> findMaximumGraphicalPartitionsPtr(
+        const Partition& startPartition,
+        unsigned int threadCount,
+        SearchStatistics* statistics
+) {
+    ThreadPool pool(threadCount);
+    vector<vector<Partition>> found;
+    SearchStatistics searchStatistics = unorderedSearch<GraphicalAscendants, MaximumGraphicalGoal<false>>(startPartition, pool, found);
     unique_ptr<unordered_set<Partition>> result(new unordered_set<Partition>());
-    unordered_set<Partition> visited;
 
-    while (!queue.empty()) {
-        Partition partition = queue.front();
-        queue.pop_front();
+    for (const auto& partitions: found) {
+        result->insert(partitions.begin(), partitions.end());
+    }
+
+    if (statistics != nullptr) {
+        *statistics = searchStatistics;
+    }
+
+    return result;
+}
+
+// region ReachableMaximumCache
+
+const ReachableMaximumCache::Reachable& ReachableMaximumCache::reachableMaximums(const Partition& startPartition) {
+    auto cached = reachable.find(startPartition);
+
+    if (cached != reachable.end()) {
+        return cached->second;
+    }
+
+    // Explicit post-order DFS, a partition is cached once all of its children are
+    struct Frame {
+        Partition partition;
+        vector<Partition> children;
+        size_t nextChild;
+    };
+
+    vector<Frame> stack;
+    stack.push_back({startPartition, {}, 0});
+
+    if (!startPartition.isMaximumGraphical()) {
+        partitionBasicGraphicalAscendants(startPartition, stack.back().children);
+    }
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+
+        while (frame.nextChild < frame.children.size() && reachable.count(frame.children[frame.nextChild]) > 0) {
+            frame.nextChild++;
+        }
+
+        if (frame.nextChild < frame.children.size()) {
+            Partition child(frame.children[frame.nextChild]);
+            stack.push_back({child, {}, 0});
+
+            if (!child.isMaximumGraphical()) {
+                partitionBasicGraphicalAscendants(child, stack.back().children);
+            }
 
-        auto alreadyFound = result->count(partition) > 0;
-        if (partition.isMaximumGraphical() && !alreadyFound) {
-            result->insert(partition);
             continue;
         }
 
-        vector<Partition> graphicalAscendants;
-        partitionGraphicalAscendants(partition, graphicalAscendants);
+        Reachable result;
+        int ownId = -1;
 
-        for (const auto& child: graphicalAscendants) {
-            if (visited.count(child) > 0) {
-                continue;
+        if (frame.partition.isMaximumGraphical()) {
+            auto interned = maximumIds.insert({frame.partition, (uint32_t) maximums.size()});
+
+            if (interned.second) {
+                maximums.push_back(frame.partition);
             }
 
-            queue.push_back(child);
+            ownId = interned.first->second;
+            result.bits.assign(ownId / 64 + 1, 0);
+            result.bits[ownId / 64] |= 1ull << (ownId % 64);
+        }
+
+        for (const auto& child: frame.children) {
+            const vector<uint64_t>& childBits = reachable.at(child).bits;
+            result.bits.resize(max(result.bits.size(), childBits.size()), 0);
+
+            for (size_t i = 0; i < childBits.size(); i++) {
+                result.bits[i] |= childBits[i];
+            }
+        }
+
+        // The position of a maximum in the distances is the number of set bits before its own
+        vector<size_t> wordOffsets(result.bits.size() + 1, 0);
+
+        for (size_t i = 0; i < result.bits.size(); i++) {
+            wordOffsets[i + 1] = wordOffsets[i] + __builtin_popcountll(result.bits[i]);
+        }
+
+        vector<uint32_t> best(wordOffsets.back(), UINT32_MAX);
+
+        if (ownId >= 0) {
+            best[wordOffsets[ownId / 64] + __builtin_popcountll(result.bits[ownId / 64] & ((1ull << (ownId % 64)) - 1))] = 0;
+        }
+
+        for (const auto& child: frame.children) {
+            const Reachable& childReachable = reachable.at(child);
+            size_t childIndex = 0;
+
+            for (size_t i = 0; i < childReachable.bits.size(); i++) {
+                for (uint64_t word = childReachable.bits[i]; word != 0; word &= word - 1) {
+                    uint64_t below = (word & -word) - 1;
+                    size_t position = wordOffsets[i] + __builtin_popcountll(result.bits[i] & below);
+                    best[position] = min(best[position], childReachable.distances[childIndex++] + 1u);
+                }
+            }
         }
 
-        visited.insert(partition);
+        result.distances.reserve(best.size());
+
+        for (uint32_t distance: best) {
+            if (distance > UINT16_MAX) {
+                stringstream message;
+                message << "Distance from '" << frame.partition << "' to a maximum graphical partition doesn't fit the cache.";
+                throw overflow_error(message.str());
+            }
+
+            result.distances.push_back((uint16_t) distance);
+        }
+
+        reachable.insert({frame.partition, move(result)});
+        stack.pop_back();
     }
 
-    return result;
+    return reachable.at(startPartition);
 }
 
-PartitionSearchAlgorithm::PartitionSearchAlgorithm(const Partition& graphicalPartition) : partition(graphicalPartition) {
-    deque<Partition> queue({graphicalPartition});
-    unordered_set<Partition> visited;
-    vector<Partition> basicGraphicalAscendants;
-    unordered_map<Partition, Partition> parent;
-
-    while(!queue.empty()) {
-        Partition frontPartition = queue.front();
-        queue.pop_front();
+unique_ptr<unordered_set<Partition>> ReachableMaximumCache::findMaximumGraphicalPartitionsPtr(const Partition& startPartition) {
+    const vector<uint64_t>& bits = reachableMaximums(startPartition).bits;
+    unique_ptr<unordered_set<Partition>> result(new unordered_set<Partition>());
 
-        if (visited.count(frontPartition) > 0) {
-            continue;
+    for (size_t i = 0; i < bits.size(); i++) {
+        for (uint64_t word = bits[i]; word != 0; word &= word - 1) {
+            result->insert(maximums[i * 64 + __builtin_ctzll(word)]);
         }
+    }
+
+    return result;
+}
+
+static bool isReverseLexicographicallyBefore(const Partition& first, const Partition& second) {
+    unsigned int length = max(first.length(), second.length());
 
-        if (frontPartition.isMaximumGraphical()) {
-            this->partitions.push_back(frontPartition);
+    for (unsigned int i = 0; i < length; i++) {
+        if (first[i] != second[i]) {
+            return first[i] > second[i];
         }
+    }
 
-        visited.insert(frontPartition);
-        basicGraphicalAscendants.clear();
-        partitionBasicGraphicalAscendants(frontPartition, basicGraphicalAscendants);
+    return false;
+}
 
-        for (const auto& child: basicGraphicalAscendants) {
-            queue.push_back(child);
-            parent.insert({child, frontPartition});
+void ReachableMaximumCache::findMaximumGraphicalPartitions(
+        const Partition& startPartition,
+        vector<Partition>& partitions,
+        vector<int>& distances
+) {
+    const Reachable& startReachable = reachableMaximums(startPartition);
+    vector<pair<uint32_t, uint32_t>> found;
+    found.reserve(startReachable.distances.size());
+
+    for (size_t i = 0; i < startReachable.bits.size(); i++) {
+        for (uint64_t word = startReachable.bits[i]; word != 0; word &= word - 1) {
+            found.push_back({startReachable.distances[found.size()], i * 64 + __builtin_ctzll(word)});
         }
     }
 
-    for (auto currentPartition: this->partitions) {
-        int distance = 0;
-        while (currentPartition != graphicalPartition) {
-            currentPartition = parent.at(currentPartition);
-            distance++;
+    // Interned ids depend on earlier queries, so ties are broken by the partitions themselves
+    sort(found.begin(), found.end(), [this](const pair<uint32_t, uint32_t>& first, const pair<uint32_t, uint32_t>& second) {
+        if (first.first != second.first) {
+            return first.first < second.first;
         }
-        this->distances.push_back(distance);
+
+        return isReverseLexicographicallyBefore(maximums[first.second], maximums[second.second]);
+    });
+
+    for (const auto& maximumDistance: found) {
+        partitions.push_back(maximums[maximumDistance.second]);
+        distances.push_back(maximumDistance.first);
+    }
+}
+
+size_t ReachableMaximumCache::size() const {
+    return reachable.size();
+}
+
+size_t ReachableMaximumCache::maximumCount() const {
+    return maximums.size();
+}
+
+// endregion
+
+// Level-synchronous BFS over basic graphical ascendants, see levelSearch.
+// Distances are the BFS levels, parents are only stored when chains are requested.
+PartitionSearchAlgorithm::PartitionSearchAlgorithm(const Partition& graphicalPartition, unsigned int threadCount, bool keepChains)
+        : partition(graphicalPartition), keepChains(keepChains)
+{
+    ThreadPool pool(threadCount);
+
+    if (keepChains) {
+        nodes.reset(new PartitionNodeStore(graphicalPartition));
+        NodeChainRecorder recorder(partitions, distances, *nodes, partitionNodes);
+        statistics = levelSearch<BasicGraphicalAscendants, MaximumGraphicalGoal<false>>(graphicalPartition, pool, recorder);
+    }
+    else {
+        DistanceRecorder recorder({partitions, distances});
+        statistics = levelSearch<BasicGraphicalAscendants, MaximumGraphicalGoal<false>>(graphicalPartition, pool, recorder);
     }
 }
 
@@ -392,3 +669,243 @@ unique_ptr<vector<Partition>> PartitionSearchAlgorithm::getPartitions() {
 unique_ptr<vector<int>> PartitionSearchAlgorithm::getDistances() {
     return make_unique<vector<int>>(distances);
 }
+
+SearchStatistics PartitionSearchAlgorithm::getStatistics() {
+    return statistics;
+}
+
+void PartitionSearchAlgorithm::checkChains() const {
+    if (!keepChains) {
+        throw logic_error("Chains are only available when PartitionSearchAlgorithm keeps them.");
+    }
+}
+
+unique_ptr<deque<Partition>> PartitionSearchAlgorithm::getChainPtr(int index) {
+    checkChains();
+
+    return nodes->partitionChainPtr(partitionNodes.at(index));
+}
+
+unique_ptr<TransitionChain> PartitionSearchAlgorithm::getTransitionChainPtr(int index) {
+    checkChains();
+
+    return nodes->transitionChainPtr(partitionNodes.at(index));
+}
+
+SortedPartitionSearchAlgorithm::SortedPartitionSearchAlgorithm(const Partition& graphicalPartition, unsigned int threadCount)
+        : partition(graphicalPartition), statistics({1, 1})
+{
+    ThreadPool pool(threadCount);
+    PartitionCodec codec(graphicalPartition.sum());
+    unsigned int words = codec.words();
+    vector<uint64_t> frontier(words);
+    codec.encode(graphicalPartition, frontier.data());
+    vector<uint64_t> visited(frontier);
+
+    for (int depth = 0; !frontier.empty(); depth++) {
+        size_t frontierCount = frontier.size() / words;
+        size_t chunkCount = min((size_t) pool.size(), frontierCount);
+        vector<vector<uint64_t>> children(chunkCount);
+        vector<vector<Partition>> maximums(chunkCount);
+
+        pool.parallelFor(chunkCount, [&](size_t chunk) {
+            vector<Partition> ascendants;
+
+            for (size_t i = chunk * frontierCount / chunkCount; i < (chunk + 1) * frontierCount / chunkCount; i++) {
+                Partition levelPartition = codec.decode(&frontier[i * words]);
+
+                if (levelPartition.isMaximumGraphical()) {
+                    maximums[chunk].push_back(levelPartition);
+                }
+
+                ascendants.clear();
+                partitionBasicGraphicalAscendants(levelPartition, ascendants);
+
+                for (const auto& child: ascendants) {
+                    children[chunk].resize(children[chunk].size() + words);
+                    codec.encode(child, &children[chunk][children[chunk].size() - words]);
+                }
+            }
+        });
+
+        frontier.clear();
+
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            for (const auto& maximum: maximums[chunk]) {
+                this->partitions.push_back(maximum);
+                this->distances.push_back(depth);
+            }
+
+            frontier.insert(frontier.end(), children[chunk].begin(), children[chunk].end());
+        }
+
+        // Basic moves may skip levels, so the children are checked against everything visited so far
+        sortUniquePacked(codec, frontier);
+        subtractPacked(codec, frontier, visited);
+        mergePacked(codec, visited, frontier);
+
+        statistics.visitedCount += frontier.size() / words;
+        statistics.peakFrontierSize = max(statistics.peakFrontierSize, frontier.size() / words);
+    }
+}
+
+unique_ptr<vector<Partition>> SortedPartitionSearchAlgorithm::getPartitions() {
+    return make_unique<vector<Partition>>(partitions);
+}
+
+unique_ptr<vector<int>> SortedPartitionSearchAlgorithm::getDistances() {
+    return make_unique<vector<int>>(distances);
+}
+
+SearchStatistics SortedPartitionSearchAlgorithm::getStatistics() {
+    return statistics;
+}
+
+// region LatticeSweepAlgorithm
+
+LatticeSweepAlgorithm::LatticeSweepAlgorithm(unsigned int sum, unsigned int threadCount) {
+    const uint16_t unreachable = numeric_limits<uint16_t>::max();
+    ThreadPool pool(threadCount);
+    PartitionCodec codec(sum);
+    unsigned int words = codec.words();
+    vector<PartitionEnumerator> ranges = PartitionEnumerator(sum, true).split(pool.size() * 8);
+    vector<vector<uint64_t>> rangeRecords(ranges.size());
+
+    pool.parallelFor(ranges.size(), [&](size_t range) {
+        while (ranges[range].next()) {
+            rangeRecords[range].resize(rangeRecords[range].size() + words);
+            codec.encode(ranges[range].current(), &rangeRecords[range][rangeRecords[range].size() - words]);
+        }
+    });
+
+    vector<uint64_t> records;
+
+    for (auto& range: rangeRecords) {
+        records.insert(records.end(), range.begin(), range.end());
+        vector<uint64_t>().swap(range);
+    }
+
+    sortUniquePacked(codec, records);
+    size_t nodeCount = records.size() / words;
+    vector<size_t> maximumIds(nodeCount, numeric_limits<size_t>::max());
+    vector<unsigned long long> squareSums(nodeCount, 0);
+    size_t maximumCount = 0;
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        partitions.push_back(codec.decode(&records[i * words]));
+
+        for (int j = 0; j < partitions[i].length(); j++) {
+            squareSums[i] += (unsigned long long) partitions[i][j] * partitions[i][j];
+        }
+
+        if (partitions[i].isMaximumGraphical()) {
+            maximumIds[i] = maximumCount++;
+        }
+    }
+
+    vector<size_t> order(nodeCount);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t first, size_t second) {
+        return squareSums[first] > squareSums[second];
+    });
+
+    vector<uint16_t> distances(nodeCount * maximumCount, unreachable);
+
+    for (size_t levelBegin = 0; levelBegin < nodeCount; ) {
+        size_t levelEnd = levelBegin;
+
+        while (levelEnd < nodeCount && squareSums[order[levelEnd]] == squareSums[order[levelBegin]]) {
+            levelEnd++;
+        }
+
+        pool.parallelFor(levelEnd - levelBegin, [&](size_t k) {
+            size_t node = order[levelBegin + k];
+            uint16_t* nodeDistances = &distances[node * maximumCount];
+
+            if (maximumIds[node] != numeric_limits<size_t>::max()) {
+                nodeDistances[maximumIds[node]] = 0;
+                return;
+            }
+
+            vector<Partition> children;
+            vector<uint64_t> record(words);
+            partitionBasicGraphicalAscendants(partitions[node], children);
+
+            for (const auto& child: children) {
+                codec.encode(child, record.data());
+                size_t low = 0;
+                size_t high = nodeCount;
+
+                while (low < high) {
+                    size_t middle = (low + high) / 2;
+
+                    if (codec.less(&records[middle * words], record.data())) {
+                        low = middle + 1;
+                    }
+                    else {
+                        high = middle;
+                    }
+                }
+
+                const uint16_t* childDistances = &distances[low * maximumCount];
+
+                for (size_t m = 0; m < maximumCount; m++) {
+                    if (childDistances[m] != unreachable) {
+                        nodeDistances[m] = min(nodeDistances[m], (uint16_t) (childDistances[m] + 1));
+                    }
+                }
+            }
+        });
+
+        levelBegin = levelEnd;
+    }
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        unsigned int reachableCount = 0;
+        int minDistance = -1;
+        int maxDistance = -1;
+
+        for (size_t m = 0; m < maximumCount; m++) {
+            int distance = distances[i * maximumCount + m];
+
+            if (distance == unreachable) {
+                continue;
+            }
+
+            reachableCount++;
+            minDistance = minDistance == -1 ? distance : min(minDistance, distance);
+            maxDistance = max(maxDistance, distance);
+        }
+
+        reachableCounts.push_back(reachableCount);
+        minDistances.push_back(minDistance);
+        maxDistances.push_back(maxDistance);
+    }
+}
+
+unique_ptr<vector<Partition>> LatticeSweepAlgorithm::getPartitions() {
+    return make_unique<vector<Partition>>(partitions);
+}
+
+unique_ptr<vector<unsigned int>> LatticeSweepAlgorithm::getReachableCounts() {
+    return make_unique<vector<unsigned int>>(reachableCounts);
+}
+
+unique_ptr<vector<int>> LatticeSweepAlgorithm::getMinDistances() {
+    return make_unique<vector<int>>(minDistances);
+}
+
+unique_ptr<vector<int>> LatticeSweepAlgorithm::getMaxDistances() {
+    return make_unique<vector<int>>(maxDistances);
+}
+
+void LatticeSweepAlgorithm::writeTable(ostream& output) {
+    output << "Reachable, Min distance, Max distance, Partition" << "\n";
+
+    for (size_t i = 0; i < partitions.size(); i++) {
+        output << reachableCounts[i] << "," << minDistances[i] << "," << maxDistances[i] << ",";
+        output << partitions[i].toCSV() << "\n";
+    }
+}
+
+// endregion
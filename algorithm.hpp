@@ -4,18 +4,24 @@
 #include "graph.hpp"
 #include "partition.hpp"
 #include "transition.hpp"
+#include "parallel.hpp"
+#include "packed.hpp"
+#include "enumeration.hpp"
+#include "sampling.hpp"
 #include <cmath>
 #include <iostream>
+#include <queue>
+#include <tuple>
 #include <unordered_set>
 #include <unordered_map>
 
 void greedyEdgeRotation(Graph &graph);
 
-unique_ptr<Graph> randomGraphPtr(unsigned int size);
+unique_ptr<Graph> randomGraphPtr(unsigned int size, RandomStream& random);
 
-unique_ptr<Partition> randomGraphPartitionPtr(unsigned int graphSize);
+unique_ptr<Partition> randomGraphPartitionPtr(unsigned int graphSize, RandomStream& random);
 
-unique_ptr<Partition> randomPartitionPtr(unsigned int sum);
+unique_ptr<Partition> randomPartitionPtr(unsigned int sum, RandomStream& random);
 
 TransitionChain partitionTransitionChain(Partition from, Partition to);
 
@@ -27,21 +33,129 @@ void partitionGraphicalAscendants(const Partition& partition, vector<Partition>&
 
 void partitionBasicGraphicalAscendants(const Partition& partition, vector<Partition>& output);
 
-unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& startPartition);
+void partitionGraphicalDescendants(const Partition& partition, vector<Partition>& output);
 
-unique_ptr<unordered_set<Partition>> findMaximumGraphicalPartitionsPtr(const Partition& startPartition);
+unsigned int maximizingMovesLowerBound(const Partition& partition);
 
+enum ChainSearchMode {
+    BREADTH_FIRST,
+    A_STAR
+};
+
+unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& startPartition, ChainSearchMode mode = BREADTH_FIRST);
+
+unique_ptr<deque<Partition>> findShortestMaximizingChainPtr(const Partition& startPartition, const unordered_set<Partition>& targetPartitions);
+
+// Distinct partitions discovered and the largest number of them waiting to be expanded at once
+struct SearchStatistics {
+    size_t visitedCount;
+    size_t peakFrontierSize;
+};
+
+unique_ptr<unordered_set<Partition>> findMaximumGraphicalPartitionsPtr(
+        const Partition& startPartition,
+        unsigned int threadCount = 1,
+        SearchStatistics* statistics = nullptr
+);
+
+// Maximum graphical partitions reachable from a partition, memoized over the ascendant DAG.
+// Every explored partition keeps a bitset over the interned maximums that is the union of its children's,
+// filled in post-order, so queries sharing territory only explore partitions not seen before.
+// Next to the bitset go the BFS distances to the maximums, two bytes for each set bit in bit order.
+class ReachableMaximumCache {
+private:
+    struct Reachable {
+        vector<uint64_t> bits;
+        vector<uint16_t> distances;
+    };
+
+    vector<Partition> maximums;
+    unordered_map<Partition, uint32_t> maximumIds;
+    unordered_map<Partition, Reachable> reachable;
+
+    const Reachable& reachableMaximums(const Partition& startPartition);
+public:
+    unique_ptr<unordered_set<Partition>> findMaximumGraphicalPartitionsPtr(const Partition& startPartition);
+
+    // Same partitions and distances as PartitionSearchAlgorithm, nearest first.
+    // Equally near partitions come in reverse lexicographic order, whatever was cached before.
+    void findMaximumGraphicalPartitions(const Partition& startPartition, vector<Partition>& partitions, vector<int>& distances);
+
+    size_t size() const;
+
+    size_t maximumCount() const;
+};
+
+// Level-synchronous BFS over basic graphical ascendants.
+// With keepChains the parents are kept as 8 byte PartitionNodeStore nodes instead of partition copies,
+// but the visited set and the frontier hold full partitions in both modes. For a smaller footprint
+// per state see SortedPartitionSearchAlgorithm and ExternalPartitionSearchAlgorithm.
 class PartitionSearchAlgorithm {
 private:
     Partition partition;
     vector<Partition> partitions;
     vector<int> distances;
+    bool keepChains;
+    unique_ptr<PartitionNodeStore> nodes;
+    vector<uint32_t> partitionNodes;
+    SearchStatistics statistics;
+
+    void checkChains() const;
+public:
+    explicit PartitionSearchAlgorithm(const Partition& graphicalPartition, unsigned int threadCount = 1, bool keepChains = false);
+
+    unique_ptr<vector<Partition>> getPartitions();
+
+    unique_ptr<vector<int>> getDistances();
+
+    unique_ptr<deque<Partition>> getChainPtr(int index);
+
+    unique_ptr<TransitionChain> getTransitionChainPtr(int index);
+
+    SearchStatistics getStatistics();
+};
+
+// PartitionSearchAlgorithm with levels kept as flat arrays of packed partitions.
+// Children are deduplicated by radix sort and subtracted from the sorted visited array by a linear merge.
+// Results come level by level, in packed order inside a level.
+class SortedPartitionSearchAlgorithm {
+private:
+    Partition partition;
+    vector<Partition> partitions;
+    vector<int> distances;
+    SearchStatistics statistics;
 public:
-    explicit PartitionSearchAlgorithm(const Partition& graphicalPartition);
+    explicit SortedPartitionSearchAlgorithm(const Partition& graphicalPartition, unsigned int threadCount = 1);
 
     unique_ptr<vector<Partition>> getPartitions();
 
     unique_ptr<vector<int>> getDistances();
+
+    SearchStatistics getStatistics();
+};
+
+// Reachable maximum graphical partitions and distances to them for every graphical partition of the sum.
+// Moves strictly increase the sum of squared columns, so partitions are processed level by level
+// from the largest value down, and every partition of a level is computed in parallel from its children.
+// Each partition keeps its BFS distance to every maximum, the minimum over its children plus one.
+class LatticeSweepAlgorithm {
+private:
+    vector<Partition> partitions;
+    vector<unsigned int> reachableCounts;
+    vector<int> minDistances;
+    vector<int> maxDistances;
+public:
+    explicit LatticeSweepAlgorithm(unsigned int sum, unsigned int threadCount = 1);
+
+    unique_ptr<vector<Partition>> getPartitions();
+
+    unique_ptr<vector<unsigned int>> getReachableCounts();
+
+    unique_ptr<vector<int>> getMinDistances();
+
+    unique_ptr<vector<int>> getMaxDistances();
+
+    void writeTable(ostream& output);
 };
 
 #endif //THRESHOLD_GRAPH_ALGORITHM_HPP
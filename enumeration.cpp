@@ -0,0 +1,181 @@
+#include "enumeration.hpp"
+
+PartitionEnumerator::PartitionEnumerator(unsigned int sum, bool graphicalOnly)
+        : PartitionEnumerator(sum, sum, 1, graphicalOnly)
+{}
+
+PartitionEnumerator::PartitionEnumerator(unsigned int sum, unsigned int largestFrom, unsigned int largestTo, bool graphicalOnly)
+        : partitionSum(sum), largestFrom(min(largestFrom, sum)), largestTo(min(largestTo, sum)), graphicalOnly(graphicalOnly),
+          parts(sum + 1, 0), atLeast(sum + 2, 0), partCount(0), lastLargePart(-1), started(false), finished(false)
+{
+    if (graphicalOnly) {
+        this->largestFrom = min(this->largestFrom, sum / 2);
+        finished = sum % 2 != 0;
+    }
+
+    if (this->largestFrom < this->largestTo) {
+        finished = true;
+    }
+
+    if (finished) {
+        return;
+    }
+
+    unsigned int largest = this->largestFrom;
+
+    for (unsigned int rest = sum; rest > 0; rest -= parts[partCount - 1]) {
+        setPart(partCount, min(largest, rest));
+        partCount++;
+
+        if (parts[partCount - 1] > 1) {
+            lastLargePart = partCount - 1;
+        }
+    }
+}
+
+void PartitionEnumerator::setPart(unsigned int index, unsigned int value) {
+    for (unsigned int j = parts[index] + 1; j <= value; j++) {
+        atLeast[j]++;
+    }
+
+    for (unsigned int j = value + 1; j <= parts[index]; j++) {
+        atLeast[j]--;
+    }
+
+    parts[index] = value;
+}
+
+void PartitionEnumerator::advance() {
+    if (lastLargePart < 0) {
+        finished = true;
+        return;
+    }
+
+    unsigned int index = lastLargePart;
+
+    if (parts[index] == 2) {
+        setPart(index, 1);
+        setPart(partCount, 1);
+        partCount++;
+        lastLargePart--;
+    }
+    else {
+        // The part shrinks by one and the freed block joins the trailing ones, regrouped into parts of the new size
+        unsigned int part = parts[index] - 1;
+        unsigned int rest = partCount - index;
+        unsigned int oldPartCount = partCount;
+        setPart(index, part);
+
+        while (rest >= part) {
+            index++;
+            setPart(index, part);
+            rest -= part;
+        }
+
+        lastLargePart = index;
+        partCount = index + 1;
+
+        if (rest > 0) {
+            setPart(partCount, rest);
+            partCount++;
+
+            if (rest > 1) {
+                lastLargePart = partCount - 1;
+            }
+        }
+
+        for (unsigned int i = partCount; i < oldPartCount; i++) {
+            setPart(i, 0);
+        }
+    }
+
+    if (parts[0] < largestTo) {
+        finished = true;
+    }
+}
+
+// Erdos-Gallai up to the Durfee rank, with the sum of min(part, k) over the remaining parts
+// taken from the conjugate: the first k conjugate parts minus the k x k square
+bool PartitionEnumerator::isGraphicalState() const {
+    long long partSum = 0;
+    long long conjugateSum = 0;
+
+    for (long long k = 1; k <= partCount && parts[k - 1] >= k; k++) {
+        partSum += parts[k - 1];
+        conjugateSum += atLeast[k];
+
+        if (partSum > k * (k - 1) + conjugateSum - k * k) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PartitionEnumerator::next() {
+    if (started) {
+        advance();
+    }
+
+    started = true;
+
+    while (!finished && graphicalOnly && !isGraphicalState()) {
+        advance();
+    }
+
+    return !finished;
+}
+
+bool PartitionEnumerator::next(Partition& output) {
+    if (!next()) {
+        return false;
+    }
+
+    output = current();
+
+    return true;
+}
+
+Partition PartitionEnumerator::current() const {
+    return Partition(vector<unsigned int>(parts.begin(), parts.begin() + partCount));
+}
+
+vector<PartitionEnumerator> PartitionEnumerator::split(unsigned int count) const {
+    // Partitions of the sum with the largest part exactly k: partitions of sum - k with parts at most k
+    vector<double> boundedCounts(partitionSum + 1, 0);
+    vector<double> weights(partitionSum + 1, 0);
+    boundedCounts[0] = 1;
+
+    for (unsigned int k = 1; k <= largestFrom; k++) {
+        for (unsigned int m = k; m <= partitionSum; m++) {
+            boundedCounts[m] += boundedCounts[m - k];
+        }
+
+        weights[k] = boundedCounts[partitionSum - k];
+    }
+
+    double total = 0;
+
+    for (unsigned int k = largestTo; k <= largestFrom; k++) {
+        total += weights[k];
+    }
+
+    vector<PartitionEnumerator> result;
+    unsigned int rangeFrom = largestFrom;
+    double accumulated = 0;
+
+    for (unsigned int k = largestFrom; k >= largestTo && k > 0; k--) {
+        accumulated += weights[k];
+
+        if (k == largestTo || accumulated >= total * (result.size() + 1) / max(count, 1u)) {
+            result.emplace_back(partitionSum, rangeFrom, k, graphicalOnly);
+            rangeFrom = k - 1;
+        }
+    }
+
+    if (result.empty()) {
+        result.emplace_back(partitionSum, largestFrom, largestTo, graphicalOnly);
+    }
+
+    return result;
+}
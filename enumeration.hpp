@@ -0,0 +1,48 @@
+#ifndef THRESHOLD_GRAPH_ENUMERATION_HPP
+#define THRESHOLD_GRAPH_ENUMERATION_HPP
+
+#include "partition.hpp"
+
+// Every partition of a sum in reverse lexicographic order, constant amortized time per step (ZS1).
+// Parts are rewritten in place from the last part greater than one, so a step only touches the suffix.
+// The graphical mode keeps the conjugate up to date with every rewritten part and checks Erdos-Gallai
+// only up to the Durfee rank, skipping largest parts above sum / 2 which are never graphical.
+// An enumerator covers the partitions whose largest part lies in a range, and split hands out
+// consecutive subranges with similar numbers of partitions (of all partitions, so graphical ranges are
+// less even and are better split into more ranges than workers).
+class PartitionEnumerator {
+private:
+    unsigned int partitionSum;
+    unsigned int largestFrom;
+    unsigned int largestTo;
+    bool graphicalOnly;
+    vector<unsigned int> parts;
+    vector<unsigned int> atLeast;
+    unsigned int partCount;
+    int lastLargePart;
+    bool started;
+    bool finished;
+
+    void setPart(unsigned int index, unsigned int value);
+
+    void advance();
+
+    bool isGraphicalState() const;
+
+public:
+    explicit PartitionEnumerator(unsigned int sum, bool graphicalOnly = false);
+
+    // Partitions with the largest part from largestFrom down to largestTo
+    PartitionEnumerator(unsigned int sum, unsigned int largestFrom, unsigned int largestTo, bool graphicalOnly);
+
+    // Steps to the next partition without building it
+    bool next();
+
+    bool next(Partition& output);
+
+    Partition current() const;
+
+    vector<PartitionEnumerator> split(unsigned int count) const;
+};
+
+#endif //THRESHOLD_GRAPH_ENUMERATION_HPP
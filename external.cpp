@@ -0,0 +1,346 @@
+#include "external.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+// region PackedRunReader
+
+PackedRunReader::PackedRunReader(const string& path, unsigned int words)
+        : stream(path, ios::binary), record(words), hasRecord(false)
+{
+    if (!stream) {
+        throw runtime_error("Can't open '" + path + "' for reading.");
+    }
+
+    next();
+}
+
+bool PackedRunReader::isValid() const {
+    return hasRecord;
+}
+
+const uint64_t* PackedRunReader::current() const {
+    return record.data();
+}
+
+void PackedRunReader::next() {
+    hasRecord = (bool) stream.read((char*) record.data(), record.size() * sizeof(uint64_t));
+}
+
+// endregion
+
+// region PackedRunWriter
+
+PackedRunWriter::PackedRunWriter(const string& path, unsigned int words)
+        : stream(path, ios::binary | ios::trunc), words(words), recordCount(0)
+{
+    if (!stream) {
+        throw runtime_error("Can't open '" + path + "' for writing.");
+    }
+}
+
+void PackedRunWriter::write(const uint64_t* record) {
+    if (!stream.write((const char*) record, words * sizeof(uint64_t))) {
+        throw runtime_error("Can't write a packed run, the disk may be full.");
+    }
+
+    recordCount++;
+}
+
+void PackedRunWriter::close() {
+    stream.close();
+
+    if (!stream) {
+        throw runtime_error("Can't write a packed run, the disk may be full.");
+    }
+}
+
+size_t PackedRunWriter::size() const {
+    return recordCount;
+}
+
+// endregion
+
+// region PackedRunMerger
+
+PackedRunMerger::PackedRunMerger(const PartitionCodec& codec, const vector<string>& paths)
+        : codec(codec), record(codec.words()), hasRecord(false)
+{
+    for (const auto& path: paths) {
+        runs.emplace_back(new PackedRunReader(path, codec.words()));
+
+        if (runs.back()->isValid()) {
+            heap.push_back(runs.size() - 1);
+        }
+    }
+
+    make_heap(heap.begin(), heap.end(), [this](size_t first, size_t second) { return isAfter(first, second); });
+    advance();
+}
+
+bool PackedRunMerger::isAfter(size_t firstRun, size_t secondRun) const {
+    return codec.less(runs[secondRun]->current(), runs[firstRun]->current());
+}
+
+// Takes the smallest record different from the current one
+void PackedRunMerger::advance() {
+    auto isAfterRun = [this](size_t first, size_t second) { return isAfter(first, second); };
+    bool hadRecord = hasRecord;
+    hasRecord = false;
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), isAfterRun);
+        size_t runIndex = heap.back();
+        bool isDuplicate = hadRecord && codec.equal(record.data(), runs[runIndex]->current());
+
+        if (!isDuplicate) {
+            copy(runs[runIndex]->current(), runs[runIndex]->current() + codec.words(), record.begin());
+            hasRecord = true;
+        }
+
+        runs[runIndex]->next();
+
+        if (runs[runIndex]->isValid()) {
+            push_heap(heap.begin(), heap.end(), isAfterRun);
+        }
+        else {
+            heap.pop_back();
+        }
+
+        if (!isDuplicate) {
+            return;
+        }
+    }
+}
+
+bool PackedRunMerger::isValid() const {
+    return hasRecord;
+}
+
+const uint64_t* PackedRunMerger::current() const {
+    return record.data();
+}
+
+void PackedRunMerger::next() {
+    advance();
+}
+
+// endregion
+
+// region TemporaryFiles
+
+TemporaryFiles::TemporaryFiles(const string& directory) : directory(directory) {}
+
+// mkstemp creates the file, so names never clash between searches or processes sharing the directory
+string TemporaryFiles::create() {
+    string pattern = directory + "/limit_graph_XXXXXX";
+    vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    int descriptor = mkstemp(path.data());
+
+    if (descriptor < 0) {
+        stringstream message;
+        message << "Can't create a temporary file in '" << directory << "': " << strerror(errno) << ".";
+        throw runtime_error(message.str());
+    }
+
+    close(descriptor);
+    paths.insert(path.data());
+
+    return string(path.data());
+}
+
+void TemporaryFiles::remove(const string& path) {
+    std::remove(path.c_str());
+    paths.erase(path);
+}
+
+TemporaryFiles::~TemporaryFiles() {
+    for (const auto& path: paths) {
+        std::remove(path.c_str());
+    }
+}
+
+// endregion
+
+// region ExternalPartitionSearchAlgorithm
+
+ExternalPartitionSearchAlgorithm::ExternalPartitionSearchAlgorithm(
+        const Partition& graphicalPartition,
+        const string& directory,
+        size_t memoryBudget,
+        unsigned int mergeFanIn
+) : partition(graphicalPartition), statistics({1, 1}), files(directory), mergeFanIn(mergeFanIn) {
+    if (mergeFanIn < 2) {
+        throw invalid_argument("Merge fan-in of the external search should be at least 2.");
+    }
+
+    PartitionCodec codec(graphicalPartition.sum());
+    // The radix sort of a run needs a scratch copy of the buffer, so each record costs twice its size
+    size_t bufferCapacity = max((size_t) 1, memoryBudget / (2 * codec.words() * sizeof(uint64_t)));
+    vector<uint64_t> record(codec.words());
+    vector<uint64_t> buffer;
+    vector<Partition> basicGraphicalAscendants;
+
+    string visitedPath = files.create();
+    string levelPath = files.create();
+    codec.encode(graphicalPartition, record.data());
+    PackedRunWriter visitedWriter(visitedPath, codec.words());
+    PackedRunWriter levelWriter(levelPath, codec.words());
+    visitedWriter.write(record.data());
+    levelWriter.write(record.data());
+    visitedWriter.close();
+    levelWriter.close();
+
+    for (int depth = 0; ; depth++) {
+        vector<string> runPaths;
+
+        for (PackedRunReader level(levelPath, codec.words()); level.isValid(); level.next()) {
+            Partition levelPartition = codec.decode(level.current());
+
+            if (levelPartition.isMaximumGraphical()) {
+                partitions.push_back(levelPartition);
+                distances.push_back(depth);
+            }
+
+            basicGraphicalAscendants.clear();
+            partitionBasicGraphicalAscendants(levelPartition, basicGraphicalAscendants);
+
+            for (const auto& child: basicGraphicalAscendants) {
+                buffer.resize(buffer.size() + codec.words());
+                codec.encode(child, buffer.data() + buffer.size() - codec.words());
+
+                if (buffer.size() / codec.words() >= bufferCapacity) {
+                    runPaths.push_back(writeRun(codec, buffer));
+                }
+            }
+        }
+
+        if (!buffer.empty()) {
+            runPaths.push_back(writeRun(codec, buffer));
+        }
+
+        files.remove(levelPath);
+
+        if (runPaths.empty()) {
+            break;
+        }
+
+        while (runPaths.size() > mergeFanIn) {
+            vector<string> mergedPaths;
+
+            for (size_t first = 0; first < runPaths.size(); first += mergeFanIn) {
+                vector<string> group(runPaths.begin() + first, runPaths.begin() + min(first + mergeFanIn, runPaths.size()));
+                mergedPaths.push_back(group.size() > 1 ? mergeRuns(codec, group) : group[0]);
+
+                if (group.size() > 1) {
+                    for (const auto& runPath: group) {
+                        files.remove(runPath);
+                    }
+                }
+            }
+
+            runPaths.swap(mergedPaths);
+        }
+
+        string newVisitedPath = files.create();
+        levelPath = files.create();
+        size_t levelSize = mergeLevel(codec, runPaths, visitedPath, levelPath, newVisitedPath);
+
+        for (const auto& runPath: runPaths) {
+            files.remove(runPath);
+        }
+
+        files.remove(visitedPath);
+        visitedPath = newVisitedPath;
+        statistics.visitedCount += levelSize;
+        statistics.peakFrontierSize = max(statistics.peakFrontierSize, levelSize);
+    }
+
+    files.remove(visitedPath);
+}
+
+string ExternalPartitionSearchAlgorithm::writeRun(const PartitionCodec& codec, vector<uint64_t>& buffer) {
+    sortUniquePacked(codec, buffer);
+
+    string path = files.create();
+    PackedRunWriter writer(path, codec.words());
+
+    for (size_t i = 0; i < buffer.size(); i += codec.words()) {
+        writer.write(&buffer[i]);
+    }
+
+    writer.close();
+    buffer.clear();
+
+    return path;
+}
+
+string ExternalPartitionSearchAlgorithm::mergeRuns(const PartitionCodec& codec, const vector<string>& runPaths) {
+    string path = files.create();
+    PackedRunWriter writer(path, codec.words());
+
+    for (PackedRunMerger merger(codec, runPaths); merger.isValid(); merger.next()) {
+        writer.write(merger.current());
+    }
+
+    writer.close();
+
+    return path;
+}
+
+size_t ExternalPartitionSearchAlgorithm::mergeLevel(
+        const PartitionCodec& codec,
+        const vector<string>& runPaths,
+        const string& visitedPath,
+        const string& levelPath,
+        const string& newVisitedPath
+) {
+    PackedRunMerger runs(codec, runPaths);
+    PackedRunReader visited(visitedPath, codec.words());
+    PackedRunWriter level(levelPath, codec.words());
+    PackedRunWriter newVisited(newVisitedPath, codec.words());
+
+    for (; runs.isValid(); runs.next()) {
+        while (visited.isValid() && codec.less(visited.current(), runs.current())) {
+            newVisited.write(visited.current());
+            visited.next();
+        }
+
+        if (!visited.isValid() || !codec.equal(visited.current(), runs.current())) {
+            level.write(runs.current());
+            newVisited.write(runs.current());
+        }
+    }
+
+    for (; visited.isValid(); visited.next()) {
+        newVisited.write(visited.current());
+    }
+
+    level.close();
+    newVisited.close();
+
+    return level.size();
+}
+
+unique_ptr<vector<Partition>> ExternalPartitionSearchAlgorithm::getPartitions() {
+    return make_unique<vector<Partition>>(partitions);
+}
+
+unique_ptr<vector<int>> ExternalPartitionSearchAlgorithm::getDistances() {
+    return make_unique<vector<int>>(distances);
+}
+
+SearchStatistics ExternalPartitionSearchAlgorithm::getStatistics() {
+    return statistics;
+}
+
+string ExternalPartitionSearchAlgorithm::defaultDirectory() {
+    const char* directory = getenv("TMPDIR");
+    return directory != nullptr ? directory : "/tmp";
+}
+
+// endregion
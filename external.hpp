@@ -0,0 +1,132 @@
+#ifndef THRESHOLD_GRAPH_EXTERNAL_HPP
+#define THRESHOLD_GRAPH_EXTERNAL_HPP
+
+#include <fstream>
+#include <unordered_set>
+#include "algorithm.hpp"
+#include "packed.hpp"
+
+// Sequential reader of a file of packed partitions
+class PackedRunReader {
+private:
+    ifstream stream;
+    vector<uint64_t> record;
+    bool hasRecord;
+
+public:
+    PackedRunReader(const string& path, unsigned int words);
+
+    bool isValid() const;
+
+    const uint64_t* current() const;
+
+    void next();
+};
+
+// Sequential writer of a file of packed partitions
+class PackedRunWriter {
+private:
+    ofstream stream;
+    unsigned int words;
+    size_t recordCount;
+
+public:
+    PackedRunWriter(const string& path, unsigned int words);
+
+    void write(const uint64_t* record);
+
+    // Flushes the buffered records, throws if they didn't make it to the file
+    void close();
+
+    size_t size() const;
+};
+
+// Sorted merge of runs of packed partitions, each partition once
+class PackedRunMerger {
+private:
+    PartitionCodec codec;
+    vector<unique_ptr<PackedRunReader>> runs;
+    vector<size_t> heap;
+    vector<uint64_t> record;
+    bool hasRecord;
+
+    bool isAfter(size_t firstRun, size_t secondRun) const;
+
+    void advance();
+
+public:
+    PackedRunMerger(const PartitionCodec& codec, const vector<string>& paths);
+
+    bool isValid() const;
+
+    const uint64_t* current() const;
+
+    void next();
+};
+
+// Temporary files in one directory, the ones still there are removed on destruction,
+// so a search leaves nothing behind when it throws
+class TemporaryFiles {
+private:
+    string directory;
+    unordered_set<string> paths;
+
+public:
+    explicit TemporaryFiles(const string& directory);
+
+    TemporaryFiles(const TemporaryFiles& other) = delete;
+
+    TemporaryFiles& operator=(const TemporaryFiles& other) = delete;
+
+    string create();
+
+    void remove(const string& path);
+
+    ~TemporaryFiles();
+};
+
+// PartitionSearchAlgorithm for regions that don't fit in memory.
+// Every BFS level is a file of sorted packed partitions. Children of a level are collected in memory
+// up to the budget, which covers both the buffer and its sort scratch, sorted and spilled as runs, then the runs are merged and the partitions already
+// visited are removed by one sequential pass over the sorted visited file (delayed duplicate detection).
+// At most mergeFanIn runs are open at once, more runs are merged in several passes.
+// Results come level by level, in packed order inside a level.
+class ExternalPartitionSearchAlgorithm {
+private:
+    Partition partition;
+    vector<Partition> partitions;
+    vector<int> distances;
+    SearchStatistics statistics;
+    TemporaryFiles files;
+    unsigned int mergeFanIn;
+
+    string writeRun(const PartitionCodec& codec, vector<uint64_t>& buffer);
+
+    string mergeRuns(const PartitionCodec& codec, const vector<string>& runPaths);
+
+    size_t mergeLevel(
+            const PartitionCodec& codec,
+            const vector<string>& runPaths,
+            const string& visitedPath,
+            const string& levelPath,
+            const string& newVisitedPath
+    );
+
+public:
+    ExternalPartitionSearchAlgorithm(
+            const Partition& graphicalPartition,
+            const string& directory,
+            size_t memoryBudget,
+            unsigned int mergeFanIn = 64
+    );
+
+    unique_ptr<vector<Partition>> getPartitions();
+
+    unique_ptr<vector<int>> getDistances();
+
+    SearchStatistics getStatistics();
+
+    static string defaultDirectory();
+};
+
+#endif //THRESHOLD_GRAPH_EXTERNAL_HPP
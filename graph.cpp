@@ -24,6 +24,11 @@ Graph::Graph(vector<vector<short>> adjacencyMatrix) {
     }
 
     this->adjacencyMatrix = adjacencyMatrix;
+    degrees.reserve(adjacencyMatrix.size());
+
+    for (auto &line: this->adjacencyMatrix) {
+        degrees.push_back(accumulate(line.begin(), line.end(), 0));
+    }
 }
 
 bool Graph::operator==(const Graph& other) const {
@@ -43,11 +48,11 @@ void Graph::rotateEdge(int x, int v, int y) {
     connect(v, y);
 }
 
-bool Graph::isIncreasingTriple(Triple *triple) {
+bool Graph::isIncreasingTriple(const Triple *triple) const {
     return isIncreasingTriple(triple->x, triple->v, triple->y);
 }
 
-bool Graph::isIncreasingTriple(int x, int v, int y) {
+bool Graph::isIncreasingTriple(int x, int v, int y) const {
     if (!areConnected(x, v) || areConnected(y, v)) {
         return false;
     }
@@ -55,11 +60,11 @@ bool Graph::isIncreasingTriple(int x, int v, int y) {
     return deg(x) <= deg(y);
 }
 
-bool Graph::isDecreasingTriple(Triple *triple) {
+bool Graph::isDecreasingTriple(const Triple *triple) const {
     return isDecreasingTriple(triple->x, triple->v, triple->y);
 }
 
-bool Graph::isDecreasingTriple(int x, int v, int y) {
+bool Graph::isDecreasingTriple(int x, int v, int y) const {
     if (!areConnected(x, v) || areConnected(y, v)) {
         return false;
     }
@@ -67,7 +72,7 @@ bool Graph::isDecreasingTriple(int x, int v, int y) {
     return deg(x) > deg(y) + 1;
 }
 
-unique_ptr<Triple> Graph::maxIncreasingTriplePtr() {
+unique_ptr<Triple> Graph::maxIncreasingTriplePtr() const {
     auto thisSize = size();
     vector<pair<int, int>> graphSequence;
     graphSequence.reserve(thisSize);
@@ -101,24 +106,30 @@ unique_ptr<Triple> Graph::maxIncreasingTriplePtr() {
     return nullptr;
 }
 
-bool Graph::areConnected(int x, int y) {
+bool Graph::areConnected(int x, int y) const {
     return adjacencyMatrix[x][y] > 0;
 }
 
 int Graph::deg(int x) const {
-    vector<short> line = adjacencyMatrix[x];
-    return accumulate(line.begin(), line.end(), 0);
+    return degrees[x];
 }
 
+// Cells are updated one at a time, so the degrees stay the row sums even for loops
 void Graph::connect(int x, int y) {
-    adjacencyMatrix[x][y] = adjacencyMatrix[y][x] = 1;
+    degrees[x] += 1 - adjacencyMatrix[x][y];
+    adjacencyMatrix[x][y] = 1;
+    degrees[y] += 1 - adjacencyMatrix[y][x];
+    adjacencyMatrix[y][x] = 1;
 }
 
 void Graph::disconnect(int x, int y) {
-    adjacencyMatrix[x][y] = adjacencyMatrix[y][x] = 0;
+    degrees[x] -= adjacencyMatrix[x][y];
+    adjacencyMatrix[x][y] = 0;
+    degrees[y] -= adjacencyMatrix[y][x];
+    adjacencyMatrix[y][x] = 0;
 }
 
-bool Graph::isLimit() {
+bool Graph::isLimit() const {
     return maxIncreasingTriplePtr() == nullptr;
 }
 
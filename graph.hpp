@@ -21,9 +21,12 @@ struct Triple {
     string toString() const;
 };
 
+// Const members only read, so one graph can be queried by many threads at once
+// as long as nobody modifies it meanwhile. Degrees are kept up to date by connect and disconnect.
 class Graph {
 private:
     vector<vector<short>> adjacencyMatrix;
+    vector<int> degrees;
 
 public:
     explicit Graph(vector<vector<short>> adjacencyMatrix);
@@ -36,17 +39,17 @@ public:
 
     void rotateEdge(int x, int v, int y);
 
-    bool isIncreasingTriple(Triple* triple);
+    bool isIncreasingTriple(const Triple* triple) const;
 
-    bool isIncreasingTriple(int x, int v, int y);
+    bool isIncreasingTriple(int x, int v, int y) const;
 
-    bool isDecreasingTriple(Triple* triple);
+    bool isDecreasingTriple(const Triple* triple) const;
 
-    bool isDecreasingTriple(int x, int v, int y);
+    bool isDecreasingTriple(int x, int v, int y) const;
 
-    unique_ptr<Triple> maxIncreasingTriplePtr();
+    unique_ptr<Triple> maxIncreasingTriplePtr() const;
 
-    bool areConnected(int x, int y);
+    bool areConnected(int x, int y) const;
 
     int deg(int x) const;
 
@@ -54,7 +57,7 @@ public:
 
     void disconnect(int x, int y);
 
-    bool isLimit();
+    bool isLimit() const;
 
     int size() const;
 
@@ -0,0 +1,154 @@
+#include "limit_graph.hpp"
+#include <sstream>
+#include <stdexcept>
+
+LimitGraphSession::LimitGraphSession(unsigned int threadCount) : pool(threadCount) {
+    clearCache();
+}
+
+ReachableMaximumCache* LimitGraphSession::acquireCache() {
+    lock_guard<mutex> guard(cacheLock);
+    ReachableMaximumCache* cache = idleCaches.back();
+    idleCaches.pop_back();
+
+    return cache;
+}
+
+void LimitGraphSession::releaseCache(ReachableMaximumCache* cache) {
+    lock_guard<mutex> guard(cacheLock);
+    idleCaches.push_back(cache);
+}
+
+vector<SearchResult> LimitGraphSession::findMaximumGraphicalPartitions(const vector<Partition>& partitions) {
+    for (size_t i = 0; i < partitions.size(); i++) {
+        if (!partitions[i].isValid() || !partitions[i].isGraphical()) {
+            stringstream message;
+            message << "Partition " << i << " of the batch is not graphical: " << partitions[i];
+            throw invalid_argument(message.str());
+        }
+    }
+
+    lock_guard<mutex> guard(callLock);
+    vector<SearchResult> results;
+    results.reserve(partitions.size());
+
+    for (size_t i = 0; i < partitions.size(); i++) {
+        results.push_back({i, partitions[i], {}, {}});
+    }
+
+    // At most pool.size() bodies run at once, so an idle cache is always there
+    pool.parallelFor(partitions.size(), [&](size_t i) {
+        ReachableMaximumCache* cache = acquireCache();
+        SearchResult& result = results[i];
+
+        try {
+            cache->findMaximumGraphicalPartitions(partitions[i], result.partitions, result.distances);
+        }
+        catch (...) {
+            releaseCache(cache);
+            throw;
+        }
+
+        releaseCache(cache);
+    });
+
+    return results;
+}
+
+void LimitGraphSession::answerQueries(istream& input, ostream& output, ostream& errors, const ResultFormatter& formatter) {
+    string line;
+    uint64_t query = 0;
+
+    while (getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+
+        vector<unsigned int> inputs;
+        uint64_t iteration = query++;
+
+        if (!parsePartitionQuery(line, inputs)) {
+            errors << "Query " << iteration << ": expected positive integers, got \"" << line << "\"" << endl;
+            continue;
+        }
+
+        Partition partition(inputs);
+
+        if (!partition.isValid() || !partition.isGraphical()) {
+            errors << "Query " << iteration << ": " << partition << " is not a graphical partition" << endl;
+            continue;
+        }
+
+        SearchResult result = findMaximumGraphicalPartitions({partition})[0];
+        result.query = iteration;
+        output << formatter.format(result);
+        output.flush();
+    }
+}
+
+void LimitGraphSession::writePartitionStats(
+        ostream& output,
+        unsigned int graphSize,
+        uint64_t seed,
+        size_t iterations,
+        const ResultFormatter& formatter
+) {
+    lock_guard<mutex> guard(callLock);
+    RandomStream random(seed);
+    output << formatter.header();
+    OrderedWriter writer(output, 4 * pool.size());
+
+    pool.parallelFor(iterations, [&](size_t i) {
+        try {
+            RandomStream stream = random.split(i);
+            Partition partition = *randomGraphPartitionPtr(graphSize, stream);
+            PartitionSearchAlgorithm algo(partition);
+            writer.submit(i, formatter.format({i, partition, *algo.getPartitions(), *algo.getDistances()}));
+        }
+        catch (...) {
+            writer.abort();
+            throw;
+        }
+    });
+
+    writer.finish();
+}
+
+vector<Partition> LimitGraphSession::randomGraphPartitions(unsigned int graphSize, uint64_t seed, size_t count) {
+    lock_guard<mutex> guard(callLock);
+    RandomStream random(seed);
+    vector<Partition> partitions(count, Partition(vector<unsigned int>()));
+
+    pool.parallelFor(count, [&](size_t i) {
+        RandomStream stream = random.split(i);
+        partitions[i] = *randomGraphPartitionPtr(graphSize, stream);
+    });
+
+    return partitions;
+}
+
+unsigned int LimitGraphSession::threadCount() const {
+    return pool.size();
+}
+
+size_t LimitGraphSession::cacheSize() {
+    lock_guard<mutex> guard(callLock);
+    size_t size = 0;
+
+    for (const auto& cache: caches) {
+        size += cache->size();
+    }
+
+    return size;
+}
+
+void LimitGraphSession::clearCache() {
+    lock_guard<mutex> guard(callLock);
+    caches.clear();
+    idleCaches.clear();
+
+    for (unsigned int i = 0; i < pool.size(); i++) {
+        caches.emplace_back(new ReachableMaximumCache());
+        idleCaches.push_back(caches.back().get());
+    }
+}
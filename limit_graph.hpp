@@ -0,0 +1,67 @@
+#ifndef THRESHOLD_GRAPH_LIMIT_GRAPH_HPP
+#define THRESHOLD_GRAPH_LIMIT_GRAPH_HPP
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <mutex>
+#include <vector>
+#include "partition.hpp"
+#include "algorithm.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "serialization.hpp"
+#include "output.hpp"
+
+using namespace std;
+
+// In-process entry point of the limit_graph library.
+// A session owns a thread pool and one search cache per pool thread that live across calls,
+// so repeated batches neither start threads nor explore the same partitions again.
+// Calls on one session are serialized.
+class LimitGraphSession {
+private:
+    ThreadPool pool;
+    vector<unique_ptr<ReachableMaximumCache>> caches;
+    vector<ReachableMaximumCache*> idleCaches;
+    mutex cacheLock;
+    mutex callLock;
+
+    ReachableMaximumCache* acquireCache();
+
+    void releaseCache(ReachableMaximumCache* cache);
+
+public:
+    explicit LimitGraphSession(unsigned int threadCount = ThreadPool::defaultSize());
+
+    LimitGraphSession(const LimitGraphSession& other) = delete;
+
+    LimitGraphSession& operator=(const LimitGraphSession& other) = delete;
+
+    // One result per partition in the same order, query is the index in the batch.
+    // Maximums come nearest first, ties in reverse lexicographic order, so results don't depend
+    // on which thread's cache answered nor on earlier calls.
+    // Throws invalid_argument before searching if any partition is not graphical.
+    vector<SearchResult> findMaximumGraphicalPartitions(const vector<Partition>& partitions);
+
+    // Answers one partition per line of input until its end, each result is flushed as soon as written.
+    // Blank lines are skipped, invalid or not graphical ones are reported to errors and keep their query number.
+    void answerQueries(istream& input, ostream& output, ostream& errors, const ResultFormatter& formatter);
+
+    // Header and results of iterations searches from the degree partitions of random G(graphSize, 1/2) graphs.
+    // Iterations run on the pool, each from its own random stream, and are written in order,
+    // the same bytes whatever the thread count.
+    void writePartitionStats(ostream& output, unsigned int graphSize, uint64_t seed, size_t iterations, const ResultFormatter& formatter);
+
+    // Degree partitions of count independent G(graphSize, 1/2) graphs, the same for the same seed
+    vector<Partition> randomGraphPartitions(unsigned int graphSize, uint64_t seed, size_t count);
+
+    unsigned int threadCount() const;
+
+    // Partitions held by all the caches together
+    size_t cacheSize();
+
+    void clearCache();
+};
+
+#endif //THRESHOLD_GRAPH_LIMIT_GRAPH_HPP
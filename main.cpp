@@ -1,10 +1,14 @@
 #include <iostream>
+#include <cstring>
 #include <deque>
 #include <unordered_set>
 #include <unordered_map>
 #include "partition.hpp"
 #include "transition.hpp"
 #include "algorithm.hpp"
+#include "output.hpp"
+#include "limit_graph.hpp"
+#include "search.hpp"
 #include "test.hpp"
 
 using namespace std;
@@ -19,7 +23,8 @@ int graphMain(int argc, char *argv[]) {
         cout << "Graph size: " << graphSize << endl;
         cout << "Random seed: " << seed << endl;
 
-        graphPtr = randomGraphPtr(graphSize);
+        RandomStream random(seed);
+        graphPtr = randomGraphPtr(graphSize, random);
     }
     else {
         graphPtr = unique_ptr<Graph>(new Graph(
@@ -62,12 +67,14 @@ int partitionMain(int argc, char *argv[]) {
         return 0;
     }
 
-    PartitionSearchAlgorithm algo(partition);
-    vector<Partition> partitions = *algo.getPartitions();
-    vector<int> distances = *algo.getDistances();
+    MaximumGraphicalPartitionStream stream(partition, ThreadPool::defaultSize());
+    Partition maximum(partition);
+    int distance;
+    AsyncOutputBuffer buffer(cout);
+    ostream output(&buffer);
 
-    for (int i = 0; i < partitions.size(); i++) {
-        cout << partitions[i] << " [Rank: " << partition.rank() << "] [Distance: " << distances[i] << "]" << endl;
+    while (stream.next(maximum, distance)) {
+        output << maximum << " [Rank: " << partition.rank() << "] [Distance: " << distance << "]" << "\n";
     }
 
     return 0;
@@ -83,7 +90,8 @@ int experimentalMain(int argc, char *argv[]) {
         cout << "Graph size: " << graphSize << endl;
         cout << "Random seed: " << seed << endl << endl;
 
-        graphPtr = randomGraphPtr(graphSize);
+        RandomStream random(seed);
+        graphPtr = randomGraphPtr(graphSize, random);
     }
     else {
         graphPtr = unique_ptr<Graph>(new Graph({
@@ -115,42 +123,81 @@ int experimentalMain(int argc, char *argv[]) {
 }
 
 int partitionStatMain(int argc, char *argv[]) {
-    if (argc != 4) {
+    if (argc != 4 && argc != 5) {
         cout << "Generates random graphical partition for graph with specified size." << endl;
         cout << "Then finds every maximum graphical partition above them." << endl;
         cout << "Please specify graph size, random seed and iterations as integer arguments." << endl;
+        cout << "Optionally specify output format: text (default), csv or binary." << endl;
         return 0;
     }
 
     unsigned int graphSize = (unsigned int) atoi(argv[1]);
     unsigned int randomSeed = (unsigned int) atoi(argv[2]);
     unsigned int iterations = (unsigned int) atoi(argv[3]);
+    ResultFormatter formatter(argc == 5 ? parseResultFormat(argv[4]) : TEXT_FORMAT);
 
-    srand(randomSeed);
+    LimitGraphSession session(ThreadPool::defaultSize());
+    AsyncOutputBuffer buffer(cout);
+    ostream output(&buffer);
+    session.writePartitionStats(output, graphSize, randomSeed, iterations, formatter);
+    buffer.close();
 
-    for (int i = 0; i < iterations; i++) {
-        cout << "Iteration " << i << endl;
-        Partition partition = *randomGraphPartitionPtr(graphSize);
-        cout << "Partition " << partition << endl;
-        PartitionSearchAlgorithm algo(partition);
-        vector<Partition> partitions = *algo.getPartitions();
-        vector<int> distances = *algo.getDistances();
+    return 0;
+}
 
-        cout << "Rank, Distance, Partition" << endl;
+int latticeMain(int argc, char *argv[]) {
+    if (argc != 2) {
+        cout << "Finds reachable maximum graphical partitions and distances to them" << endl;
+        cout << "for every graphical partition with specified sum." << endl;
+        cout << "Please specify the sum as integer argument." << endl;
+        return 0;
+    }
+
+    auto sum = (unsigned int) atoi(argv[1]);
+    LatticeSweepAlgorithm algo(sum, ThreadPool::defaultSize());
+    AsyncOutputBuffer buffer(cout);
+    ostream output(&buffer);
+    algo.writeTable(output);
+
+    return 0;
+}
 
-        for (int j = 0; j < partitions.size(); j++) {
-            cout << partitions[j].rank() << "," << distances[j] << "," << partitions[j].toCSV() << endl;
-        }
+// Answers queries until end of input, one partition per line, keeping the search cache between queries
+int batchMain(int argc, char *argv[]) {
+    if (argc > 3) {
+        cout << "Reads partitions from standard input, one per line as descending integers," << endl;
+        cout << "and finds every maximum graphical partition above each of them." << endl;
+        cout << "Usage: program batch [text|csv|binary]" << endl;
+        return 0;
     }
 
+    ResultFormatter formatter(argc == 3 ? parseResultFormat(argv[2]) : TEXT_FORMAT);
+    // Queries come one at a time, so a single thread keeps all of them in one cache
+    LimitGraphSession session(1);
+    AsyncOutputBuffer buffer(cout);
+    ostream output(&buffer);
+    output << formatter.header();
+    output.flush();
+
+    session.answerQueries(cin, output, cerr, formatter);
+    buffer.close();
+
     return 0;
 }
 
 int main(int argc, char *argv[]) {
-    LimitGraphTest::all();
+    if (argc > 1 && strcmp(argv[1], "batch") == 0) {
+        return batchMain(argc, argv);
+    }
+
+    // Self-tests print to standard output, so they stay out of the way of csv and binary results
+    if (argc != 5 || parseResultFormat(argv[4]) == TEXT_FORMAT) {
+        LimitGraphTest::all();
+    }
 
     //return graphMain(argc, argv);
     //return partitionMain(argc, argv);
+    //return latticeMain(argc, argv);
     return partitionStatMain(argc, argv);
 }
 
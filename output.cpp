@@ -0,0 +1,212 @@
+#include "output.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+ResultFormat parseResultFormat(const string& name) {
+    if (name == "text") {
+        return TEXT_FORMAT;
+    }
+
+    if (name == "csv") {
+        return CSV_FORMAT;
+    }
+
+    if (name == "binary") {
+        return BINARY_FORMAT;
+    }
+
+    throw invalid_argument("Unknown output format '" + name + "', expected text, csv or binary.");
+}
+
+bool parsePartitionQuery(const string& line, vector<unsigned int>& values) {
+    istringstream input(line);
+    string token;
+
+    while (input >> token) {
+        if (token[0] < '0' || token[0] > '9') {
+            return false;
+        }
+
+        char* end;
+        errno = 0;
+        unsigned long long value = strtoull(token.c_str(), &end, 10);
+
+        if (errno != 0 || *end != '\0' || value == 0 || value > UINT_MAX) {
+            return false;
+        }
+
+        values.push_back((unsigned int) value);
+    }
+
+    return !values.empty();
+}
+
+// region ResultFormatter
+
+ResultFormatter::ResultFormatter(ResultFormat format) : resultFormat(format) {}
+
+string ResultFormatter::header() const {
+    stringstream result;
+
+    if (resultFormat == CSV_FORMAT) {
+        result << "Iteration, Rank, Distance, Partition" << "\n";
+    }
+    else if (resultFormat == BINARY_FORMAT) {
+        BinaryWriter writer(result);
+    }
+
+    return result.str();
+}
+
+string ResultFormatter::format(const SearchResult& result) const {
+    stringstream output;
+
+    switch (resultFormat) {
+        case TEXT_FORMAT:
+            output << "Iteration " << result.query << "\n";
+            output << "Partition " << result.start << "\n";
+            output << "Rank, Distance, Partition" << "\n";
+
+            for (size_t i = 0; i < result.partitions.size(); i++) {
+                output << result.partitions[i].rank() << "," << result.distances[i] << ",";
+                output << result.partitions[i].toCSV() << "\n";
+            }
+
+            break;
+        case CSV_FORMAT:
+            for (size_t i = 0; i < result.partitions.size(); i++) {
+                output << result.query << "," << result.partitions[i].rank() << "," << result.distances[i] << ",";
+                output << result.partitions[i].toCSV() << "\n";
+            }
+
+            break;
+        case BINARY_FORMAT:
+            BinaryWriter(output, false).write(result);
+            break;
+    }
+
+    return output.str();
+}
+
+// endregion
+
+// region AsyncOutputBuffer
+
+AsyncOutputBuffer::AsyncOutputBuffer(ostream& output, size_t capacity)
+        : output(output), ring(max(capacity, (size_t) 1)), readPosition(0), usedSize(0),
+          staging(min(ring.size(), (size_t) 1 << 12)), closing(false)
+{
+    setp(staging.data(), staging.data() + staging.size());
+    writer = thread(&AsyncOutputBuffer::writerLoop, this);
+}
+
+// The chunk being written stays counted as used, so writers never overwrite it
+void AsyncOutputBuffer::writerLoop() {
+    unique_lock<mutex> guard(lock);
+
+    while (true) {
+        dataReady.wait(guard, [this] { return usedSize > 0 || closing; });
+
+        if (usedSize == 0) {
+            break;
+        }
+
+        size_t chunkSize = min(usedSize, ring.size() - readPosition);
+        const char* chunk = &ring[readPosition];
+
+        guard.unlock();
+        output.write(chunk, chunkSize);
+        guard.lock();
+
+        readPosition = (readPosition + chunkSize) % ring.size();
+        usedSize -= chunkSize;
+        spaceReady.notify_all();
+
+        // Drained, so an interactive reader on the other end of a pipe sees the text now
+        if (usedSize == 0) {
+            guard.unlock();
+            output.flush();
+            guard.lock();
+        }
+    }
+
+    output.flush();
+}
+
+void AsyncOutputBuffer::push(const char* data, size_t size) {
+    unique_lock<mutex> guard(lock);
+
+    while (size > 0) {
+        spaceReady.wait(guard, [this] { return usedSize < ring.size(); });
+
+        size_t writePosition = (readPosition + usedSize) % ring.size();
+        size_t chunkSize = min(size, min(ring.size() - usedSize, ring.size() - writePosition));
+        memcpy(&ring[writePosition], data, chunkSize);
+        usedSize += chunkSize;
+        data += chunkSize;
+        size -= chunkSize;
+        dataReady.notify_one();
+    }
+}
+
+void AsyncOutputBuffer::pushStaging() {
+    push(pbase(), pptr() - pbase());
+    setp(staging.data(), staging.data() + staging.size());
+}
+
+int AsyncOutputBuffer::overflow(int character) {
+    pushStaging();
+
+    if (character != traits_type::eof()) {
+        *pptr() = (char) character;
+        pbump(1);
+    }
+
+    return traits_type::not_eof(character);
+}
+
+streamsize AsyncOutputBuffer::xsputn(const char* data, streamsize size) {
+    if (size > epptr() - pptr()) {
+        pushStaging();
+    }
+
+    if (size >= (streamsize) staging.size()) {
+        push(data, (size_t) size);
+    }
+    else {
+        memcpy(pptr(), data, (size_t) size);
+        pbump((int) size);
+    }
+
+    return size;
+}
+
+int AsyncOutputBuffer::sync() {
+    pushStaging();
+    return 0;
+}
+
+void AsyncOutputBuffer::close() {
+    if (!writer.joinable()) {
+        return;
+    }
+
+    pushStaging();
+
+    {
+        lock_guard<mutex> guard(lock);
+        closing = true;
+        dataReady.notify_all();
+    }
+
+    writer.join();
+}
+
+AsyncOutputBuffer::~AsyncOutputBuffer() {
+    close();
+}
+
+// endregion
@@ -0,0 +1,78 @@
+#ifndef THRESHOLD_GRAPH_OUTPUT_HPP
+#define THRESHOLD_GRAPH_OUTPUT_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include "serialization.hpp"
+
+enum ResultFormat {
+    TEXT_FORMAT,
+    CSV_FORMAT,
+    BINARY_FORMAT
+};
+
+ResultFormat parseResultFormat(const string& name);
+
+// Whitespace separated integers in 1..UINT_MAX, false if any token is anything else or there are none
+bool parsePartitionQuery(const string& line, vector<unsigned int>& values);
+
+// Search results as text (the partitionStatMain layout), CSV with one line per found partition,
+// or binary result records after the BinaryWriter header
+class ResultFormatter {
+private:
+    ResultFormat resultFormat;
+
+public:
+    explicit ResultFormatter(ResultFormat format);
+
+    string header() const;
+
+    string format(const SearchResult& result) const;
+};
+
+// Stream buffer handing the bytes to a dedicated I/O thread through a bounded ring buffer.
+// Writers only copy into the ring and block when it is full, so a slow consumer slows
+// the computation down instead of growing the buffer. Flushing (endl) doesn't wait for the I/O,
+// the I/O thread flushes the underlying stream itself whenever the ring drains.
+class AsyncOutputBuffer : public streambuf {
+private:
+    ostream& output;
+    vector<char> ring;
+    size_t readPosition;
+    size_t usedSize;
+    vector<char> staging;
+    mutex lock;
+    condition_variable dataReady;
+    condition_variable spaceReady;
+    bool closing;
+    thread writer;
+
+    void writerLoop();
+
+    void push(const char* data, size_t size);
+
+    void pushStaging();
+
+protected:
+    int overflow(int character) override;
+
+    streamsize xsputn(const char* data, streamsize size) override;
+
+    int sync() override;
+
+public:
+    explicit AsyncOutputBuffer(ostream& output, size_t capacity = 1 << 20);
+
+    AsyncOutputBuffer(const AsyncOutputBuffer& other) = delete;
+
+    AsyncOutputBuffer& operator=(const AsyncOutputBuffer& other) = delete;
+
+    // Writes everything buffered and stops the I/O thread
+    void close();
+
+    ~AsyncOutputBuffer() override;
+};
+
+#endif //THRESHOLD_GRAPH_OUTPUT_HPP
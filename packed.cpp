@@ -0,0 +1,265 @@
+#include "packed.hpp"
+
+#include <limits>
+#include <numeric>
+
+// region PartitionCodec
+
+PartitionCodec::PartitionCodec(unsigned int sum) : partitionSum(sum), wordCount((sum + 1 + 63) / 64) {}
+
+unsigned int PartitionCodec::sum() const {
+    return partitionSum;
+}
+
+unsigned int PartitionCodec::words() const {
+    return wordCount;
+}
+
+void PartitionCodec::encode(const Partition& partition, uint64_t* output) const {
+    if (partition.sum() != partitionSum) {
+        stringstream message;
+        message << "Partition '" << partition << "' can't be packed with sum " << partitionSum << ".";
+        throw invalid_argument(message.str());
+    }
+
+    fill(output, output + wordCount, 0);
+    unsigned int bit = 0;
+    unsigned int previousHeight = 0;
+
+    for (int i = partition.length() - 1; i >= 0; i--) {
+        bit += partition[i] - previousHeight;
+        output[bit / 64] |= 1ull << (bit % 64);
+        bit++;
+        previousHeight = partition[i];
+    }
+}
+
+Partition PartitionCodec::decode(const uint64_t* input) const {
+    vector<unsigned int> content;
+    unsigned int height = 0;
+    unsigned int decodedSum = 0;
+
+    for (unsigned int bit = 0; decodedSum < partitionSum && bit < wordCount * 64; bit++) {
+        if ((input[bit / 64] >> (bit % 64) & 1) == 0) {
+            height++;
+            continue;
+        }
+
+        content.push_back(height);
+        decodedSum += height;
+    }
+
+    reverse(content.begin(), content.end());
+
+    return Partition(content);
+}
+
+bool PartitionCodec::less(const uint64_t* first, const uint64_t* second) const {
+    return lexicographical_compare(first, first + wordCount, second, second + wordCount);
+}
+
+bool PartitionCodec::equal(const uint64_t* first, const uint64_t* second) const {
+    return std::equal(first, first + wordCount, second);
+}
+
+// endregion
+
+// region Packed arrays
+
+void sortUniquePacked(const PartitionCodec& codec, vector<uint64_t>& records) {
+    unsigned int words = codec.words();
+    size_t recordCount = records.size() / words;
+    vector<uint64_t> sorted(records.size());
+
+    // The first word is the most significant one, so the passes go from the last word's lowest byte
+    for (int word = words - 1; word >= 0; word--) {
+        for (unsigned int shift = 0; shift < 64; shift += 8) {
+            size_t offsets[257] = {};
+
+            for (size_t i = 0; i < recordCount; i++) {
+                offsets[(records[i * words + word] >> shift & 0xFF) + 1]++;
+            }
+
+            if (*max_element(offsets + 1, offsets + 257) == recordCount) {
+                continue;
+            }
+
+            partial_sum(offsets, offsets + 257, offsets);
+
+            for (size_t i = 0; i < recordCount; i++) {
+                size_t position = offsets[records[i * words + word] >> shift & 0xFF]++;
+                copy(&records[i * words], &records[i * words] + words, &sorted[position * words]);
+            }
+
+            records.swap(sorted);
+        }
+    }
+
+    size_t uniqueCount = 0;
+
+    for (size_t i = 0; i < recordCount; i++) {
+        if (uniqueCount > 0 && codec.equal(&records[(uniqueCount - 1) * words], &records[i * words])) {
+            continue;
+        }
+
+        copy(&records[i * words], &records[i * words] + words, &records[uniqueCount * words]);
+        uniqueCount++;
+    }
+
+    records.resize(uniqueCount * words);
+}
+
+void subtractPacked(const PartitionCodec& codec, vector<uint64_t>& records, const vector<uint64_t>& excluded) {
+    unsigned int words = codec.words();
+    size_t keptCount = 0;
+    size_t j = 0;
+
+    for (size_t i = 0; i < records.size(); i += words) {
+        while (j < excluded.size() && codec.less(&excluded[j], &records[i])) {
+            j += words;
+        }
+
+        if (j < excluded.size() && codec.equal(&excluded[j], &records[i])) {
+            continue;
+        }
+
+        copy(&records[i], &records[i] + words, &records[keptCount]);
+        keptCount += words;
+    }
+
+    records.resize(keptCount);
+}
+
+void mergePacked(const PartitionCodec& codec, vector<uint64_t>& records, const vector<uint64_t>& added) {
+    unsigned int words = codec.words();
+    vector<uint64_t> merged;
+    merged.reserve(records.size() + added.size());
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < records.size() || j < added.size()) {
+        if (j == added.size() || (i < records.size() && codec.less(&records[i], &added[j]))) {
+            merged.insert(merged.end(), &records[i], &records[i] + words);
+            i += words;
+        }
+        else {
+            merged.insert(merged.end(), &added[j], &added[j] + words);
+            j += words;
+        }
+    }
+
+    records.swap(merged);
+}
+
+// endregion
+
+// region PartitionNodeStore
+
+const uint32_t PartitionNodeStore::ROOT;
+
+PartitionNodeStore::PartitionNodeStore(const Partition& root, unsigned int checkpointInterval)
+        : nodes({{ROOT, 0, 0}}), checkpoints({{ROOT, root}}), checkpointInterval(max(checkpointInterval, 1u))
+{}
+
+uint32_t PartitionNodeStore::add(uint32_t parent, const Partition& parentPartition, const Partition& partition) {
+    if (nodes.size() > numeric_limits<uint32_t>::max()) {
+        throw runtime_error("Partition node store is full.");
+    }
+
+    unsigned int length = max(parentPartition.length(), partition.length());
+    int fromColumn = -1;
+    int toColumn = -1;
+
+    for (int i = 0; i < length; i++) {
+        if (partition[i] == parentPartition[i] - 1 && fromColumn == -1) {
+            fromColumn = i;
+        }
+        else if (partition[i] == parentPartition[i] + 1 && toColumn == -1) {
+            toColumn = i;
+        }
+        else if (partition[i] != parentPartition[i]) {
+            fromColumn = -1;
+            break;
+        }
+    }
+
+    if (fromColumn == -1 || toColumn == -1 || max(fromColumn, toColumn) > numeric_limits<uint16_t>::max()) {
+        stringstream message;
+        message << "Partition '" << partition << "' is not one move away from '" << parentPartition << "'.";
+        throw invalid_argument(message.str());
+    }
+
+    uint32_t node = (uint32_t) nodes.size();
+    nodes.push_back({parent, (uint16_t) fromColumn, (uint16_t) toColumn});
+    unsigned int distance = 1;
+
+    for (uint32_t ancestor = parent; checkpoints.count(ancestor) == 0; ancestor = nodes[ancestor].parent) {
+        distance++;
+    }
+
+    if (distance >= checkpointInterval) {
+        checkpoints.insert({node, partition});
+    }
+
+    return node;
+}
+
+// Nodes strictly below the ancestor down to the node, top first
+vector<uint32_t> PartitionNodeStore::pathFrom(uint32_t ancestor, uint32_t node) const {
+    vector<uint32_t> path;
+
+    for (; node != ancestor; node = nodes.at(node).parent) {
+        path.push_back(node);
+    }
+
+    reverse(path.begin(), path.end());
+
+    return path;
+}
+
+Partition PartitionNodeStore::partition(uint32_t node) const {
+    uint32_t checkpoint = node;
+
+    while (checkpoints.count(checkpoint) == 0) {
+        checkpoint = nodes.at(checkpoint).parent;
+    }
+
+    Partition result(checkpoints.at(checkpoint));
+
+    for (uint32_t pathNode: pathFrom(checkpoint, node)) {
+        result.move(nodes[pathNode].fromColumn, nodes[pathNode].toColumn);
+    }
+
+    return result;
+}
+
+unique_ptr<deque<Partition>> PartitionNodeStore::partitionChainPtr(uint32_t node) const {
+    unique_ptr<deque<Partition>> result(new deque<Partition>({checkpoints.at(ROOT)}));
+
+    for (uint32_t pathNode: pathFrom(ROOT, node)) {
+        result->push_back(result->back());
+        result->back().move(nodes[pathNode].fromColumn, nodes[pathNode].toColumn);
+    }
+
+    return result;
+}
+
+unique_ptr<TransitionChain> PartitionNodeStore::transitionChainPtr(uint32_t node) const {
+    unique_ptr<TransitionChain> result(new TransitionChain());
+    Partition current(checkpoints.at(ROOT));
+
+    for (uint32_t pathNode: pathFrom(ROOT, node)) {
+        int fromColumn = nodes[pathNode].fromColumn;
+        int toColumn = nodes[pathNode].toColumn;
+        result->push_back(new PartitionMove(fromColumn, current[fromColumn] - 1, toColumn, current[toColumn]));
+        current.move(fromColumn, toColumn);
+    }
+
+    return result;
+}
+
+size_t PartitionNodeStore::size() const {
+    return nodes.size();
+}
+
+// endregion
@@ -0,0 +1,77 @@
+#ifndef THRESHOLD_GRAPH_PACKED_HPP
+#define THRESHOLD_GRAPH_PACKED_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include "partition.hpp"
+#include "transition.hpp"
+
+// Fixed-width encoding of the partitions of one sum as the boundary of the Young diagram.
+// Columns are written from the last one: the height difference to the previous column as zero bits,
+// then a one bit. That takes length + largest column <= sum + 1 bits, so all partitions of the sum
+// fit the same number of words and can be sorted and compared as plain word arrays.
+class PartitionCodec {
+private:
+    unsigned int partitionSum;
+    unsigned int wordCount;
+
+public:
+    explicit PartitionCodec(unsigned int sum);
+
+    unsigned int sum() const;
+
+    unsigned int words() const;
+
+    void encode(const Partition& partition, uint64_t* output) const;
+
+    Partition decode(const uint64_t* input) const;
+
+    bool less(const uint64_t* first, const uint64_t* second) const;
+
+    bool equal(const uint64_t* first, const uint64_t* second) const;
+};
+
+// Sorts a flat array of packed partitions with LSD radix sort and drops repeated records
+void sortUniquePacked(const PartitionCodec& codec, vector<uint64_t>& records);
+
+// Removes from sorted unique records every record present in sorted unique excluded records
+void subtractPacked(const PartitionCodec& codec, vector<uint64_t>& records, const vector<uint64_t>& excluded);
+
+// Merges two disjoint sorted arrays of packed partitions into the first one
+void mergePacked(const PartitionCodec& codec, vector<uint64_t>& records, const vector<uint64_t>& added);
+
+// Search tree where every node is its parent and the move from it, 8 bytes instead of a Partition copy.
+// Partitions are rebuilt by replaying the moves from the nearest checkpoint above the node,
+// and a full copy is kept once every checkpointInterval levels.
+class PartitionNodeStore {
+private:
+    struct Node {
+        uint32_t parent;
+        uint16_t fromColumn;
+        uint16_t toColumn;
+    };
+
+    vector<Node> nodes;
+    unordered_map<uint32_t, Partition> checkpoints;
+    unsigned int checkpointInterval;
+
+    vector<uint32_t> pathFrom(uint32_t ancestor, uint32_t node) const;
+
+public:
+    static const uint32_t ROOT = 0;
+
+    explicit PartitionNodeStore(const Partition& root, unsigned int checkpointInterval = 16);
+
+    // Adds a partition reached from the parent node by one move and returns its node
+    uint32_t add(uint32_t parent, const Partition& parentPartition, const Partition& partition);
+
+    Partition partition(uint32_t node) const;
+
+    unique_ptr<deque<Partition>> partitionChainPtr(uint32_t node) const;
+
+    unique_ptr<TransitionChain> transitionChainPtr(uint32_t node) const;
+
+    size_t size() const;
+};
+
+#endif //THRESHOLD_GRAPH_PACKED_HPP
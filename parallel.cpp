@@ -0,0 +1,408 @@
+#include "parallel.hpp"
+
+// region ThreadPool
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+        : body(nullptr), bodyCount(0), nextIndex(0), generation(0), activeWorkers(0), stopping(false)
+{
+    for (unsigned int i = 1; i < threadCount; i++) {
+        workers.emplace_back([this](){ workerLoop(); });
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned int seenGeneration = 0;
+
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this, seenGeneration](){ return stopping || generation != seenGeneration; });
+
+            if (stopping) {
+                return;
+            }
+
+            seenGeneration = generation;
+        }
+
+        runBody();
+
+        {
+            lock_guard<mutex> guard(lock);
+
+            if (--activeWorkers == 0) {
+                done.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::runBody() {
+    size_t index;
+
+    while ((index = nextIndex.fetch_add(1)) < bodyCount) {
+        try {
+            (*body)(index);
+        }
+        catch (...) {
+            lock_guard<mutex> guard(lock);
+
+            if (failure == nullptr) {
+                failure = current_exception();
+            }
+
+            nextIndex = bodyCount;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t)>& loopBody) {
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            loopBody(i);
+        }
+
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        body = &loopBody;
+        bodyCount = count;
+        nextIndex = 0;
+        failure = nullptr;
+        activeWorkers = workers.size();
+        generation++;
+    }
+
+    wake.notify_all();
+    runBody();
+
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this](){ return activeWorkers == 0; });
+    body = nullptr;
+
+    if (failure != nullptr) {
+        rethrow_exception(failure);
+    }
+}
+
+unsigned int ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+unsigned int ThreadPool::defaultSize() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (auto& worker: workers) {
+        worker.join();
+    }
+}
+
+// endregion
+
+// region ConcurrentPartitionSet
+
+struct ConcurrentPartitionSet::Node {
+    const bool isLeaf;
+
+    explicit Node(bool isLeaf) : isLeaf(isLeaf) {}
+};
+
+struct ConcurrentPartitionSet::Leaf : public ConcurrentPartitionSet::Node {
+    const uint64_t hash;
+    const Partition partition;
+    atomic<Leaf*> next;
+
+    Leaf(uint64_t hash, const Partition& partition)
+            : Node(true), hash(hash), partition(partition), next(nullptr)
+    {}
+};
+
+struct ConcurrentPartitionSet::Inner : public ConcurrentPartitionSet::Node {
+    atomic<Node*> children[1u << LEVEL_BITS];
+
+    Inner() : Node(false) {
+        for (auto& child: children) {
+            child.store(nullptr, memory_order_relaxed);
+        }
+    }
+};
+
+ConcurrentPartitionSet::ConcurrentPartitionSet() : root(1u << ROOT_BITS), count(0) {
+    for (auto& slot: root) {
+        slot.store(nullptr, memory_order_relaxed);
+    }
+}
+
+uint64_t ConcurrentPartitionSet::mix(size_t hash) {
+    uint64_t result = hash;
+    result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ull;
+    result = (result ^ (result >> 27)) * 0x94d049bb133111ebull;
+    return result ^ (result >> 31);
+}
+
+bool ConcurrentPartitionSet::insert(const Partition& partition) {
+    const uint64_t levelMask = (1u << LEVEL_BITS) - 1;
+    uint64_t hash = mix(partition.hashCode());
+    atomic<Node*>* slot = &root[hash & ((1u << ROOT_BITS) - 1)];
+    unsigned int shift = ROOT_BITS;
+    unique_ptr<Leaf> created;
+
+    while (true) {
+        Node* current = slot->load(memory_order_acquire);
+
+        if (current == nullptr) {
+            if (created == nullptr) {
+                created.reset(new Leaf(hash, partition));
+            }
+
+            if (slot->compare_exchange_strong(current, created.get(), memory_order_acq_rel)) {
+                created.release();
+                count.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+
+            continue;
+        }
+
+        if (!current->isLeaf) {
+            slot = &static_cast<Inner*>(current)->children[(hash >> shift) & levelMask];
+            shift += LEVEL_BITS;
+            continue;
+        }
+
+        auto leaf = static_cast<Leaf*>(current);
+
+        if (leaf->hash != hash) {
+            // Push the existing leaf one level down and retry there
+            auto inner = new Inner();
+            inner->children[(leaf->hash >> shift) & levelMask].store(leaf, memory_order_relaxed);
+
+            if (!slot->compare_exchange_strong(current, inner, memory_order_acq_rel)) {
+                delete inner;
+            }
+
+            continue;
+        }
+
+        // Full hash collision, partitions are chained
+        while (true) {
+            if (leaf->partition == partition) {
+                return false;
+            }
+
+            Leaf* next = leaf->next.load(memory_order_acquire);
+
+            if (next == nullptr) {
+                if (created == nullptr) {
+                    created.reset(new Leaf(hash, partition));
+                }
+
+                if (leaf->next.compare_exchange_strong(next, created.get(), memory_order_acq_rel)) {
+                    created.release();
+                    count.fetch_add(1, memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            leaf = next;
+        }
+    }
+}
+
+bool ConcurrentPartitionSet::contains(const Partition& partition) const {
+    const uint64_t levelMask = (1u << LEVEL_BITS) - 1;
+    uint64_t hash = mix(partition.hashCode());
+    Node* current = root[hash & ((1u << ROOT_BITS) - 1)].load(memory_order_acquire);
+    unsigned int shift = ROOT_BITS;
+
+    while (current != nullptr && !current->isLeaf) {
+        current = static_cast<Inner*>(current)->children[(hash >> shift) & levelMask].load(memory_order_acquire);
+        shift += LEVEL_BITS;
+    }
+
+    for (auto leaf = static_cast<Leaf*>(current); leaf != nullptr; leaf = leaf->next.load(memory_order_acquire)) {
+        if (leaf->hash == hash && leaf->partition == partition) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t ConcurrentPartitionSet::size() const {
+    return count.load();
+}
+
+void ConcurrentPartitionSet::destroy(Node* node) {
+    if (node == nullptr) {
+        return;
+    }
+
+    if (node->isLeaf) {
+        auto leaf = static_cast<Leaf*>(node);
+
+        while (leaf != nullptr) {
+            auto next = leaf->next.load(memory_order_relaxed);
+            delete leaf;
+            leaf = next;
+        }
+
+        return;
+    }
+
+    auto inner = static_cast<Inner*>(node);
+
+    for (auto& child: inner->children) {
+        destroy(child.load(memory_order_relaxed));
+    }
+
+    delete inner;
+}
+
+ConcurrentPartitionSet::~ConcurrentPartitionSet() {
+    for (auto& slot: root) {
+        destroy(slot.load(memory_order_relaxed));
+    }
+}
+
+// endregion
+
+// region WorkStealingQueue
+
+WorkStealingQueue::WorkStealingQueue(unsigned int workerCount) : pending(0), peakPending(0) {
+    for (unsigned int i = 0; i < workerCount; i++) {
+        slots.emplace_back(new Slot());
+    }
+}
+
+void WorkStealingQueue::push(unsigned int worker, const Partition& partition) {
+    size_t currentPending = pending.fetch_add(1) + 1;
+    size_t currentPeak = peakPending.load();
+
+    while (currentPending > currentPeak && !peakPending.compare_exchange_weak(currentPeak, currentPending)) {}
+
+    lock_guard<mutex> guard(slots[worker]->lock);
+    slots[worker]->items.push_back(partition);
+}
+
+bool WorkStealingQueue::pop(unsigned int worker, Partition& output) {
+    for (unsigned int i = 0; i < slots.size(); i++) {
+        Slot& slot = *slots[(worker + i) % slots.size()];
+        lock_guard<mutex> guard(slot.lock);
+
+        if (slot.items.empty()) {
+            continue;
+        }
+
+        if (i == 0) {
+            output = slot.items.back();
+            slot.items.pop_back();
+        }
+        else {
+            output = slot.items.front();
+            slot.items.pop_front();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingQueue::finish() {
+    pending.fetch_sub(1);
+}
+
+bool WorkStealingQueue::isFinished() const {
+    return pending.load() == 0;
+}
+
+size_t WorkStealingQueue::peakSize() const {
+    return peakPending.load();
+}
+
+// endregion
+
+// region OrderedWriter
+
+OrderedWriter::OrderedWriter(ostream& output, size_t window)
+        : output(output), window(max(window, (size_t) 1)), nextIndex(0), finishing(false), aborted(false)
+{
+    writer = thread(&OrderedWriter::writerLoop, this);
+}
+
+void OrderedWriter::writerLoop() {
+    unique_lock<mutex> guard(lock);
+
+    while (true) {
+        ready.wait(guard, [this] { return pending.count(nextIndex) > 0 || finishing || aborted; });
+
+        if (aborted || pending.empty()) {
+            break;
+        }
+
+        // Finishing with a gap only happens when an index was never submitted, write the rest in order
+        auto next = pending.count(nextIndex) > 0 ? pending.find(nextIndex) : pending.begin();
+        string text = move(next->second);
+        nextIndex = next->first + 1;
+        pending.erase(next);
+        space.notify_all();
+
+        guard.unlock();
+        output << text;
+        guard.lock();
+    }
+
+    output.flush();
+}
+
+void OrderedWriter::submit(size_t index, string text) {
+    unique_lock<mutex> guard(lock);
+    space.wait(guard, [&] { return index < nextIndex + window || aborted; });
+
+    if (aborted) {
+        return;
+    }
+
+    pending.insert({index, move(text)});
+
+    if (index == nextIndex) {
+        ready.notify_one();
+    }
+}
+
+void OrderedWriter::abort() {
+    lock_guard<mutex> guard(lock);
+    aborted = true;
+    ready.notify_all();
+    space.notify_all();
+}
+
+void OrderedWriter::finish() {
+    {
+        lock_guard<mutex> guard(lock);
+        finishing = true;
+        ready.notify_all();
+    }
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+OrderedWriter::~OrderedWriter() {
+    finish();
+}
+
+// endregion
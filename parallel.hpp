@@ -0,0 +1,153 @@
+#ifndef THRESHOLD_GRAPH_PARALLEL_HPP
+#define THRESHOLD_GRAPH_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "partition.hpp"
+
+using namespace std;
+
+// Fixed set of worker threads running one indexed loop at a time.
+// The calling thread takes part in the loop, so a pool of size 1 runs everything inline.
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+
+    const function<void(size_t)>* body;
+    size_t bodyCount;
+    atomic<size_t> nextIndex;
+    exception_ptr failure;
+    unsigned int generation;
+    unsigned int activeWorkers;
+    bool stopping;
+
+    void workerLoop();
+
+    void runBody();
+
+public:
+    explicit ThreadPool(unsigned int threadCount);
+
+    ThreadPool(const ThreadPool& other) = delete;
+
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    void parallelFor(size_t count, const function<void(size_t)>& loopBody);
+
+    unsigned int size() const;
+
+    static unsigned int defaultSize();
+
+    ~ThreadPool();
+};
+
+// Insert-only hash trie of partitions. Threads insert concurrently without locks:
+// every slot only ever changes from empty to a leaf and from a leaf to an inner node by a CAS.
+class ConcurrentPartitionSet {
+private:
+    struct Node;
+    struct Leaf;
+    struct Inner;
+
+    static const unsigned int ROOT_BITS = 10;
+    static const unsigned int LEVEL_BITS = 6;
+
+    vector<atomic<Node*>> root;
+    atomic<size_t> count;
+
+    static uint64_t mix(size_t hash);
+
+    static void destroy(Node* node);
+
+public:
+    ConcurrentPartitionSet();
+
+    ConcurrentPartitionSet(const ConcurrentPartitionSet& other) = delete;
+
+    ConcurrentPartitionSet& operator=(const ConcurrentPartitionSet& other) = delete;
+
+    bool insert(const Partition& partition);
+
+    bool contains(const Partition& partition) const;
+
+    size_t size() const;
+
+    ~ConcurrentPartitionSet();
+};
+
+// Per-worker deques of pending partitions. The owner takes its newest partition (depth first),
+// idle workers steal the oldest partition of another worker.
+class WorkStealingQueue {
+private:
+    struct Slot {
+        mutex lock;
+        deque<Partition> items;
+    };
+
+    vector<unique_ptr<Slot>> slots;
+    atomic<size_t> pending;
+    atomic<size_t> peakPending;
+
+public:
+    explicit WorkStealingQueue(unsigned int workerCount);
+
+    void push(unsigned int worker, const Partition& partition);
+
+    bool pop(unsigned int worker, Partition& output);
+
+    void finish();
+
+    bool isFinished() const;
+
+    size_t peakSize() const;
+};
+
+// Writes texts submitted by workers in any order to a stream in index order, from its own thread.
+// A worker blocks while its index is window or more ahead of the next one to be written,
+// so memory stays bounded when one index is slow. Indices have to be taken in increasing order,
+// as parallelFor does, or the worker holding the next one may never get to it.
+// abort releases everyone after a failed worker.
+class OrderedWriter {
+private:
+    ostream& output;
+    size_t window;
+    mutex lock;
+    condition_variable ready;
+    condition_variable space;
+    map<size_t, string> pending;
+    size_t nextIndex;
+    bool finishing;
+    bool aborted;
+    thread writer;
+
+    void writerLoop();
+
+public:
+    OrderedWriter(ostream& output, size_t window);
+
+    OrderedWriter(const OrderedWriter& other) = delete;
+
+    OrderedWriter& operator=(const OrderedWriter& other) = delete;
+
+    void submit(size_t index, string text);
+
+    void abort();
+
+    // Writes everything submitted and stops the writer thread
+    void finish();
+
+    ~OrderedWriter();
+};
+
+#endif //THRESHOLD_GRAPH_PARALLEL_HPP
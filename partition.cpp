@@ -1,5 +1,7 @@
 #include "partition.hpp"
 
+#include <limits>
+
 // region Partition
 
 Partition::Partition(const vector<unsigned int>& content) :
@@ -20,14 +22,35 @@ Partition Partition::from(const Graph& graph) {
     vector<unsigned int> vertexDegrees;
 
     for (int vertex = 0; vertex < graph.size(); vertex++) {
-        auto vertexDegree = (unsigned int)graph.deg(vertex);
+        vertexDegrees.push_back((unsigned int) graph.deg(vertex));
+    }
 
-        if (vertexDegree > 0) {
-            vertexDegrees.push_back(vertexDegree);
-        }
+    return fromDegrees(vertexDegrees);
+}
+
+// Degrees sorted descending by counting, zero degrees are dropped
+Partition Partition::fromDegrees(const vector<unsigned int>& degrees) {
+    unsigned long long degreeSum = accumulate(degrees.begin(), degrees.end(), 0ull);
+
+    if (degreeSum > numeric_limits<unsigned int>::max()) {
+        stringstream message;
+        message << "Degree sum " << degreeSum << " doesn't fit a partition.";
+        throw overflow_error(message.str());
     }
 
-    sort(vertexDegrees.begin(), vertexDegrees.end(), greater<unsigned int>());
+    unsigned int maxDegree = degrees.empty() ? 0 : *max_element(degrees.begin(), degrees.end());
+    vector<unsigned int> degreeCounts(maxDegree + 1, 0);
+
+    for (unsigned int degree: degrees) {
+        degreeCounts[degree]++;
+    }
+
+    vector<unsigned int> vertexDegrees;
+    vertexDegrees.reserve(degrees.size() - degreeCounts[0]);
+
+    for (unsigned int degree = maxDegree; degree > 0; degree--) {
+        vertexDegrees.insert(vertexDegrees.end(), degreeCounts[degree], degree);
+    }
 
     return Partition(vertexDegrees);
 }
@@ -152,7 +175,7 @@ Partition Partition::tail() const {
     return Partition(vector<unsigned int>(content.begin() + rank(), content.end())).conjugate();
 }
 
-Partition Partition::conjugate() {
+Partition Partition::conjugate() const {
     auto resultContent = vector<unsigned int>();
 
     for (int i = 0; i < (*this)[0]; i++) {
@@ -172,6 +195,54 @@ Partition Partition::conjugate() {
     return Partition(resultContent);
 }
 
+// Maximum graphical partition obtained by filling the head row by row and mirroring it into the tail.
+// Same result as ColoredPartition::maximize, but computed in one pass over the head columns.
+Partition Partition::maximumGraphical() const {
+    if (!isGraphical()) {
+        throw invalid_argument("Partition must be graphical.");
+    }
+
+    unsigned int thisRank = rank();
+    vector<unsigned int> resultContent(content.begin(), content.begin() + thisRank);
+
+    unsigned int headSum = 0;
+    for (unsigned int i = 0; i < thisRank; i++) {
+        headSum += content[i] - (thisRank - 1);
+    }
+
+    unsigned int halfDelta = (num - accumulate(resultContent.begin(), resultContent.end(), 0u) - headSum) / 2;
+    unsigned int fillFrom = thisRank;
+
+    for (unsigned int rowIndex = thisRank; halfDelta > 0; rowIndex++) {
+        while (fillFrom > 0 && resultContent[fillFrom - 1] <= rowIndex) {
+            fillFrom--;
+        }
+
+        unsigned int filled = min(thisRank - fillFrom, halfDelta);
+
+        for (unsigned int i = fillFrom; i < fillFrom + filled; i++) {
+            resultContent[i]++;
+        }
+
+        halfDelta -= filled;
+    }
+
+    if (thisRank > 0) {
+        unsigned int headHeight = resultContent[0] - (thisRank - 1);
+        unsigned int headLength = thisRank;
+
+        for (unsigned int rowIndex = 0; rowIndex < headHeight; rowIndex++) {
+            while (resultContent[headLength - 1] - (thisRank - 1) <= rowIndex) {
+                headLength--;
+            }
+
+            resultContent.push_back(headLength);
+        }
+    }
+
+    return Partition(resultContent);
+}
+
 bool Partition::operator==(const Partition& other) const {
     if (num != other.num) {
         return false;
@@ -226,11 +297,13 @@ unsigned int Partition::operator[](int index) const {
     return index < content.size() ? content[index] : 0;
 }
 
+// Trailing zero columns are left out, as operator== ignores them
 size_t Partition::hashCode() const {
-    size_t seed = content.size();
+    unsigned int thisLength = length();
+    size_t seed = thisLength;
 
-    for(auto& i : content) {
-        seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    for (unsigned int i = 0; i < thisLength; i++) {
+        seed ^= content[i] + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     }
 
     return seed;
@@ -273,34 +346,166 @@ string Partition::toCSV() const {
 
 // endregion
 
-// region ColoredPartition
+// region ColorGrid
+
+static const unsigned int CELLS_PER_WORD = 32;
+static const uint64_t LOW_CELL_BITS = 0x5555555555555555ull;
 
-void ColoredPartition::resizeColorsVertically() {
-    for (auto& color: colors) {
-        color.resize(partition[0], NONE);
+static uint64_t encodeColor(Color color) {
+    switch (color) {
+        case BLACK: return 1;
+        case GREY: return 2;
+        default: return 0;
     }
 }
 
-void ColoredPartition::resizeColors() {
-    unsigned int partitionLength = partition.length();
+static Color decodeColor(uint64_t bits) {
+    switch (bits) {
+        case 1: return BLACK;
+        case 2: return GREY;
+        default: return NONE;
+    }
+}
+
+// Mask of the cells [from, to) inside a single word
+static uint64_t cellMask(unsigned int from, unsigned int to) {
+    uint64_t upper = to >= CELLS_PER_WORD ? ~0ull : (1ull << (2 * to)) - 1;
+    uint64_t lower = (1ull << (2 * from)) - 1;
+    return upper & ~lower;
+}
+
+ColorGrid::ColorGrid() : columnCapacity(0), wordsPerColumn(0) {}
+
+ColorGrid::ColorGrid(unsigned int columns, unsigned int rows) : columnCapacity(0), wordsPerColumn(0) {
+    reserve(columns, rows);
+}
+
+uint64_t ColorGrid::word(unsigned int columnIndex, unsigned int wordIndex) const {
+    if (columnIndex >= columnCapacity || wordIndex >= wordsPerColumn) {
+        return 0;
+    }
+
+    return words[columnIndex * wordsPerColumn + wordIndex];
+}
 
-    if (partitionLength > colors.size()) {
-        colors.resize(partitionLength);
+void ColorGrid::reserve(unsigned int columns, unsigned int rows) {
+    unsigned int requiredWords = (rows + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
 
-        resizeColorsVertically();
+    if (columns <= columnCapacity && requiredWords <= wordsPerColumn) {
+        return;
     }
 
-    if (partition[0] > colors[0].size()) {
-        resizeColorsVertically();
+    unsigned int newColumnCapacity = columns > columnCapacity ? max(columns, 2 * columnCapacity) : columnCapacity;
+    unsigned int newWordsPerColumn = requiredWords > wordsPerColumn ? max(requiredWords, 2 * wordsPerColumn) : wordsPerColumn;
+
+    if (newWordsPerColumn == wordsPerColumn) {
+        // Columns are stored one after another, so new columns are simply appended
+        words.resize(newColumnCapacity * newWordsPerColumn, 0);
+    }
+    else {
+        vector<uint64_t> newWords(newColumnCapacity * newWordsPerColumn, 0);
+
+        for (unsigned int i = 0; i < columnCapacity; i++) {
+            auto columnBegin = words.begin() + i * wordsPerColumn;
+            copy(columnBegin, columnBegin + wordsPerColumn, newWords.begin() + i * newWordsPerColumn);
+        }
+
+        words.swap(newWords);
+    }
+
+    columnCapacity = newColumnCapacity;
+    wordsPerColumn = newWordsPerColumn;
+}
+
+Color ColorGrid::get(int columnIndex, int rowIndex) const {
+    if (columnIndex < 0 || rowIndex < 0) {
+        return NONE;
+    }
+
+    uint64_t bits = word(columnIndex, rowIndex / CELLS_PER_WORD) >> (2 * (rowIndex % CELLS_PER_WORD));
+
+    return decodeColor(bits & 3);
+}
+
+void ColorGrid::set(Color color, int columnIndex, int rowIndex) {
+    fill(color, columnIndex, rowIndex, rowIndex + 1);
+}
+
+void ColorGrid::fill(Color color, int columnIndex, int fromRow, int toRow) {
+    if (fromRow >= toRow) {
+        return;
+    }
+
+    reserve(columnIndex + 1, toRow);
+
+    uint64_t pattern = encodeColor(color) * LOW_CELL_BITS;
+    auto column = words.begin() + columnIndex * wordsPerColumn;
+    unsigned int lastWord = (toRow - 1) / CELLS_PER_WORD;
+
+    for (unsigned int i = fromRow / CELLS_PER_WORD; i <= lastWord; i++) {
+        unsigned int wordStart = i * CELLS_PER_WORD;
+        uint64_t mask = cellMask(max(fromRow, (int) wordStart) - wordStart, min(toRow - wordStart, CELLS_PER_WORD));
+        column[i] = (column[i] & ~mask) | (pattern & mask);
+    }
+}
+
+bool ColorGrid::isFilled(Color color, int columnIndex, int fromRow, int toRow) const {
+    uint64_t pattern = encodeColor(color) * LOW_CELL_BITS;
+
+    for (int i = fromRow / (int) CELLS_PER_WORD; i * (int) CELLS_PER_WORD < toRow; i++) {
+        int wordStart = i * CELLS_PER_WORD;
+        uint64_t mask = cellMask(max(fromRow, wordStart) - wordStart, min(toRow - wordStart, (int) CELLS_PER_WORD));
+
+        if ((word(columnIndex, i) & mask) != (pattern & mask)) {
+            return false;
+        }
     }
+
+    return true;
+}
+
+bool ColorGrid::isValid() const {
+    // Code 3 does not correspond to any color
+    return none_of(words.begin(), words.end(), [](uint64_t w){ return (w & (w >> 1) & LOW_CELL_BITS) != 0; });
+}
+
+unsigned int ColorGrid::columns() const {
+    return columnCapacity;
+}
+
+unsigned int ColorGrid::rows() const {
+    return wordsPerColumn * CELLS_PER_WORD;
+}
+
+bool ColorGrid::operator==(const ColorGrid& other) const {
+    unsigned int maxColumns = max(columnCapacity, other.columnCapacity);
+    unsigned int maxWords = max(wordsPerColumn, other.wordsPerColumn);
+
+    for (unsigned int i = 0; i < maxColumns; i++) {
+        for (unsigned int j = 0; j < maxWords; j++) {
+            if (word(i, j) != other.word(i, j)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// endregion
+
+// region ColoredPartition
+
+void ColoredPartition::resizeColors() {
+    colors.reserve(partition.length(), partition[0]);
 }
 
 ColoredPartition::ColoredPartition(const vector<unsigned int>& content)
-        : partition(content), colors(content.size(), vector<Color>(content[0], NONE))
+        : partition(content), colors(partition.length(), partition[0])
 {}
 
 ColoredPartition::ColoredPartition(const Partition& other)
-        : partition(other), colors(other.length(), vector<Color>(other[0], NONE))
+        : partition(other), colors(other.length(), other[0])
 {}
 
 ColoredPartition::ColoredPartition(const ColoredPartition& other)
@@ -310,8 +515,8 @@ ColoredPartition::ColoredPartition(const ColoredPartition& other)
 void ColoredPartition::move(int from, int to) {
     partition.move(from, to);
     resizeColors();
-    colors[to][partition[to] - 1] = colors[from][partition[from]];
-    colors[from][partition[from]] = NONE;
+    colors.set(colors.get(from, partition[from]), to, partition[to] - 1);
+    colors.set(NONE, from, partition[from]);
 }
 
 void ColoredPartition::insert(int columnIndex) {
@@ -321,56 +526,49 @@ void ColoredPartition::insert(int columnIndex) {
 
 void ColoredPartition::remove(int columnIndex) {
     partition.remove(columnIndex);
-    colors[columnIndex][partition[columnIndex]] = NONE;
+    colors.set(NONE, columnIndex, partition[columnIndex]);
 }
 
 void ColoredPartition::paint(Color color, int columnIndex) {
-    colors[columnIndex][partition[columnIndex] - 1] = color;
+    colors.set(color, columnIndex, partition[columnIndex] - 1);
 }
 
 void ColoredPartition::paint(Color color, int columnIndex, int rowIndex) {
-    colors[columnIndex][rowIndex] = color;
+    colors.set(color, columnIndex, rowIndex);
 }
 
 Color ColoredPartition::getColor(int columnIndex) const {
-    if (columnIndex > colors.size()) {
-        return NONE;
-    }
-
-    return colors[columnIndex][partition[columnIndex] - 1];
+    return getColor(columnIndex, (int) partition[columnIndex] - 1);
 }
 
 Color ColoredPartition::getColor(int columnIndex, int rowIndex) const {
-    if (columnIndex > colors.size()) {
+    if (rowIndex >= (int) partition[columnIndex]) {
         return NONE;
     }
 
-    if (rowIndex > partition[columnIndex] - 1) {
-        return NONE;
-    }
-
-    return colors[columnIndex][rowIndex];
+    return colors.get(columnIndex, rowIndex);
 }
 
-bool ColoredPartition::hasBlock(int columnIndex, int rowIndex) {
+bool ColoredPartition::hasBlock(int columnIndex, int rowIndex) const {
     return partition[columnIndex] > rowIndex;
 }
 
 void ColoredPartition::paintHeadBlack() {
     int thisRank = rank();
 
-    for (int rowIndex = thisRank - 1; rowIndex < partition[0]; rowIndex++) {
-        for (int columnIndex = 0; columnIndex < thisRank; columnIndex++) {
-            if (hasBlock(columnIndex, rowIndex)) {
-                paint(BLACK, columnIndex, rowIndex);
-            }
-        }
+    for (int columnIndex = 0; columnIndex < thisRank; columnIndex++) {
+        colors.fill(BLACK, columnIndex, thisRank - 1, partition[columnIndex]);
     }
 }
 
 void ColoredPartition::fillHead() {
     int halfDelta = (partition.tail().sum() - partition.head().sum()) / 2;
     int thisRank = rank();
+    vector<unsigned int> headHeights(thisRank);
+
+    for (int columnIndex = 0; columnIndex < thisRank; columnIndex++) {
+        headHeights[columnIndex] = partition[columnIndex];
+    }
 
     for (int rowIndex = thisRank; rowIndex < 2*thisRank; rowIndex++) {
         if (halfDelta == 0) {
@@ -379,8 +577,7 @@ void ColoredPartition::fillHead() {
 
         for (int columnIndex = 0; columnIndex < thisRank; columnIndex++) {
             if (!hasBlock(columnIndex, rowIndex)) {
-                insert(columnIndex);
-                paint(GREY, columnIndex);
+                partition.insert(columnIndex);
                 halfDelta--;
             }
 
@@ -389,81 +586,69 @@ void ColoredPartition::fillHead() {
             }
         }
     }
+
+    resizeColors();
+
+    for (int columnIndex = 0; columnIndex < thisRank; columnIndex++) {
+        colors.fill(GREY, columnIndex, headHeights[columnIndex], partition[columnIndex]);
+    }
 }
 
 void ColoredPartition::maximize() {
-    paintHeadBlack();
-    fillHead();
-    Partition conjugateHead = partition.head().conjugate();
+    Partition maximum = partition.maximumGraphical();
     int thisRank = rank();
-    int thisLength = length();
+    int thisLength = max(length(), maximum.length());
 
-    partition.replaceTail(conjugateHead);
+    paintHeadBlack();
+    colors.reserve(thisLength, maximum[0]);
+
+    for (int i = 0; i < thisRank; i++) {
+        colors.fill(GREY, i, partition[i], maximum[i]);
+    }
+
+    partition = maximum;
 
     for (int i = thisRank; i < thisLength; i++) {
+        colors.fill(NONE, i, partition[i], colors.rows());
+
         for (int j = 0; j < partition[i]; j++) {
-            colors[i][j] = colors[j][i - 1];
+            colors.set(colors.get(j, i - 1), i, j);
         }
     }
 }
 
-bool ColoredPartition::isValid() {
+bool ColoredPartition::isValid() const {
     if (!partition.isValid()) {
         return false;
     }
 
-    if (colors.size() < partition.length()) {
+    if (!colors.isValid()) {
         return false;
     }
 
-    for (int i = 0; i < colors.size(); i++) {
-        if (colors[i].size() < partition[i]) {
+    for (int i = 0; i < colors.columns(); i++) {
+        if (!colors.isFilled(NONE, i, partition[i], colors.rows())) {
             return false;
         }
-
-        for (int j = 0; j < colors[i].size(); j++) {
-            if (j < partition[i]
-                && colors[i][j] != BLACK
-                && colors[i][j] != GREY
-                && colors[i][j] != NONE) {
-                return false;
-            }
-
-            if (j >= partition[i] && colors[i][j] != NONE) {
-                return false;
-            }
-        }
     }
 
     return true;
 }
 
-unsigned int ColoredPartition::sum() {
+unsigned int ColoredPartition::sum() const {
     return partition.sum();
 }
 
-unsigned int ColoredPartition::length() {
+unsigned int ColoredPartition::length() const {
     return partition.length();
 }
 
-unsigned int ColoredPartition::rank() {
+unsigned int ColoredPartition::rank() const {
     return partition.rank();
 }
 
 bool ColoredPartition::operator==(const ColoredPartition& other) const {
-    if (partition != other.partition) {
-        return false;
-    }
-
-    for (int i = 0; i < min(colors.size(), other.colors.size()); i++) {
-        for (int j = 0; j < min(colors[i].size(), other.colors[i].size()); j++) {
-            if (colors[i][j] != other.colors[i][j]) {
-                return false;
-            }
-        }
-    }
-
-    return true;
+    return partition == other.partition && colors == other.colors;
 }
 
 unsigned int ColoredPartition::operator[](int index) const {
@@ -502,6 +687,134 @@ string ColoredPartition::toString() const {
 
 // endregion
 
+// region PartitionBatch
+
+PartitionBatch::PartitionBatch(const vector<Partition>& partitions)
+        : batchSize(partitions.size()), width(0), sums(partitions.size())
+{
+    for (const auto& partition: partitions) {
+        width = max(width, partition.length());
+    }
+
+    cells.resize(width * batchSize);
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        sums[i] = partitions[i].sum();
+
+        for (unsigned int j = 0; j < width; j++) {
+            column(j)[i] = partitions[i][j];
+        }
+    }
+}
+
+unsigned int* PartitionBatch::column(int columnIndex) {
+    return cells.data() + columnIndex * batchSize;
+}
+
+const unsigned int* PartitionBatch::column(int columnIndex) const {
+    return cells.data() + columnIndex * batchSize;
+}
+
+void PartitionBatch::resizeColumns(unsigned int columns) {
+    if (columns > width) {
+        cells.resize(columns * batchSize, 0);
+        width = columns;
+    }
+}
+
+void PartitionBatch::move(int from, int to) {
+    resizeColumns((unsigned int) max(from, to) + 1);
+
+    unsigned int* fromColumn = column(from);
+    unsigned int* toColumn = column(to);
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        fromColumn[i]--;
+    }
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        toColumn[i]++;
+    }
+}
+
+void PartitionBatch::insert(int columnIndex) {
+    resizeColumns((unsigned int) columnIndex + 1);
+
+    unsigned int* targetColumn = column(columnIndex);
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        targetColumn[i]++;
+        sums[i]++;
+    }
+}
+
+void PartitionBatch::remove(int columnIndex) {
+    resizeColumns((unsigned int) columnIndex + 1);
+
+    unsigned int* targetColumn = column(columnIndex);
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        targetColumn[i]--;
+        sums[i]--;
+    }
+}
+
+bool PartitionBatch::isValid() const {
+    // Removing from an empty column wraps around, which breaks either the order or the sum
+    vector<uint64_t> actualSums(batchSize, 0);
+    bool sorted = true;
+
+    for (unsigned int j = 0; j < width; j++) {
+        const unsigned int* current = column(j);
+
+        for (unsigned int i = 0; i < batchSize; i++) {
+            actualSums[i] += current[i];
+        }
+
+        if (j + 1 < width) {
+            const unsigned int* next = column(j + 1);
+
+            for (unsigned int i = 0; i < batchSize; i++) {
+                sorted &= current[i] >= next[i];
+            }
+        }
+    }
+
+    return sorted && equal(actualSums.begin(), actualSums.end(), sums.begin());
+}
+
+unsigned int PartitionBatch::size() const {
+    return batchSize;
+}
+
+unsigned int PartitionBatch::columns() const {
+    return width;
+}
+
+Partition PartitionBatch::operator[](int index) const {
+    vector<unsigned int> content;
+    content.reserve(width);
+
+    for (unsigned int j = 0; j < width && column(j)[index] > 0; j++) {
+        content.push_back(column(j)[index]);
+    }
+
+    return Partition(content);
+}
+
+vector<Partition> PartitionBatch::toPartitions() const {
+    vector<Partition> result;
+    result.reserve(batchSize);
+
+    for (unsigned int i = 0; i < batchSize; i++) {
+        result.push_back((*this)[i]);
+    }
+
+    return result;
+}
+
+// endregion
+
 // region Output
 
 ostream &operator<<(ostream &strm, const Partition &partition) {
@@ -2,6 +2,7 @@
 #define THRESHOLD_GRAPH_PARTITION_HPP
 
 #include <deque>
+#include <cstdint>
 #include "graph.hpp"
 
 using namespace std;
@@ -20,6 +21,8 @@ public:
 
     static Partition from(const Graph& graph);
 
+    static Partition fromDegrees(const vector<unsigned int>& degrees);
+
     void move(int from, int to);
 
     void insert(int columnIndex);
@@ -52,7 +55,9 @@ public:
 
     Partition tail() const;
 
-    Partition conjugate();
+    Partition conjugate() const;
+
+    Partition maximumGraphical() const;
 
     bool operator==(const Partition& other) const;
 
@@ -84,12 +89,44 @@ enum Color {
     NONE = 'N'
 };
 
+// Column-major grid of colors packed 2 bits per cell, 32 cells per word.
+// Capacity grows geometrically and never shrinks, cells outside the grid are NONE.
+class ColorGrid {
+private:
+    vector<uint64_t> words;
+    unsigned int columnCapacity;
+    unsigned int wordsPerColumn;
+
+    uint64_t word(unsigned int columnIndex, unsigned int wordIndex) const;
+
+public:
+    ColorGrid();
+
+    ColorGrid(unsigned int columns, unsigned int rows);
+
+    void reserve(unsigned int columns, unsigned int rows);
+
+    Color get(int columnIndex, int rowIndex) const;
+
+    void set(Color color, int columnIndex, int rowIndex);
+
+    void fill(Color color, int columnIndex, int fromRow, int toRow);
+
+    bool isFilled(Color color, int columnIndex, int fromRow, int toRow) const;
+
+    bool isValid() const;
+
+    unsigned int columns() const;
+
+    unsigned int rows() const;
+
+    bool operator==(const ColorGrid& other) const;
+};
+
 class ColoredPartition {
 private:
     Partition partition;
-    vector<vector<Color>> colors;
-
-    void resizeColorsVertically();
+    ColorGrid colors;
 
     void resizeColors();
 
@@ -114,7 +151,7 @@ public:
 
     Color getColor(int columnIndex, int rowIndex) const;
 
-    bool hasBlock(int columnIndex, int rowIndex);
+    bool hasBlock(int columnIndex, int rowIndex) const;
 
     void paintHeadBlack();
 
@@ -122,13 +159,13 @@ public:
 
     void maximize();
 
-    bool isValid();
+    bool isValid() const;
 
-    unsigned int sum();
+    unsigned int sum() const;
 
-    unsigned int length();
+    unsigned int length() const;
 
-    unsigned int rank();
+    unsigned int rank() const;
 
     bool operator==(const ColoredPartition& other) const;
 
@@ -139,6 +176,41 @@ public:
     string toString() const;
 };
 
+// Many partitions stored as structure of arrays: the same column of every partition is contiguous,
+// so a transition is applied to the whole batch by a single loop over one or two columns.
+class PartitionBatch {
+private:
+    unsigned int batchSize;
+    unsigned int width;
+    vector<unsigned int> cells;
+    vector<unsigned int> sums;
+
+    unsigned int* column(int columnIndex);
+
+    const unsigned int* column(int columnIndex) const;
+
+    void resizeColumns(unsigned int columns);
+
+public:
+    explicit PartitionBatch(const vector<Partition>& partitions);
+
+    void move(int from, int to);
+
+    void insert(int columnIndex);
+
+    void remove(int columnIndex);
+
+    bool isValid() const;
+
+    unsigned int size() const;
+
+    unsigned int columns() const;
+
+    Partition operator[](int index) const;
+
+    vector<Partition> toPartitions() const;
+};
+
 ostream &operator<<(ostream &strm, const Partition &partition);
 
 ostream &operator<<(ostream &strm, const Color &color);
@@ -0,0 +1,86 @@
+#include "random.hpp"
+
+#include <algorithm>
+
+// region RandomStream
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+// SplitMix64 finalizer, spreads stream indices over the whole stream space
+static uint64_t mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream, uint64_t counter)
+        : seedValue(seed), streamValue(stream), counterValue(counter), block{0, 0}, blockIndex(0)
+{}
+
+RandomStream RandomStream::split(uint64_t index) const {
+    return RandomStream(seedValue, mix(streamValue ^ mix(index + 1)));
+}
+
+uint64_t RandomStream::seed() const {
+    return seedValue;
+}
+
+uint64_t RandomStream::stream() const {
+    return streamValue;
+}
+
+uint64_t RandomStream::counter() const {
+    return counterValue;
+}
+
+// One block of 128 bits for the counter (counterValue, stream) and the key seed
+void RandomStream::generateBlock() {
+    uint32_t counter[4] = {
+            (uint32_t) counterValue, (uint32_t) (counterValue >> 32),
+            (uint32_t) streamValue, (uint32_t) (streamValue >> 32)
+    };
+    uint32_t key[2] = {(uint32_t) seedValue, (uint32_t) (seedValue >> 32)};
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = (uint64_t) PHILOX_M0 * counter[0];
+        uint64_t product1 = (uint64_t) PHILOX_M1 * counter[2];
+
+        uint32_t next[4] = {
+                (uint32_t) (product1 >> 32) ^ counter[1] ^ key[0],
+                (uint32_t) product1,
+                (uint32_t) (product0 >> 32) ^ counter[3] ^ key[1],
+                (uint32_t) product0
+        };
+
+        copy(next, next + 4, counter);
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+
+    block[0] = (uint64_t) counter[1] << 32 | counter[0];
+    block[1] = (uint64_t) counter[3] << 32 | counter[2];
+}
+
+uint64_t RandomStream::operator()() {
+    if (blockIndex == 0) {
+        generateBlock();
+    }
+
+    uint64_t result = block[blockIndex];
+    blockIndex ^= 1;
+
+    if (blockIndex == 0) {
+        counterValue++;
+    }
+
+    return result;
+}
+
+double RandomStream::uniform() {
+    return (((*this)() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// endregion
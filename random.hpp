@@ -0,0 +1,52 @@
+#ifndef THRESHOLD_GRAPH_RANDOM_HPP
+#define THRESHOLD_GRAPH_RANDOM_HPP
+
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al.): the output is a pure function
+// of (seed, stream, counter), so any position of any stream can be reached directly
+// and results don't depend on which thread draws them. Every counter value gives two numbers.
+// split derives an independent stream, e.g. one per iteration or per vertex block.
+// Satisfies UniformRandomBitGenerator, so it works with <random> distributions.
+class RandomStream {
+private:
+    uint64_t seedValue;
+    uint64_t streamValue;
+    uint64_t counterValue;
+    uint64_t block[2];
+    unsigned int blockIndex;
+
+    void generateBlock();
+
+public:
+    typedef uint64_t result_type;
+
+    explicit RandomStream(uint64_t seed, uint64_t stream = 0, uint64_t counter = 0);
+
+    RandomStream split(uint64_t index) const;
+
+    uint64_t seed() const;
+
+    uint64_t stream() const;
+
+    // Counter of the block the next number comes from
+    uint64_t counter() const;
+
+    uint64_t operator()();
+
+    // Uniform in (0, 1], safe to take the logarithm of
+    double uniform();
+
+    static constexpr uint64_t min() {
+        return 0;
+    }
+
+    static constexpr uint64_t max() {
+        return numeric_limits<uint64_t>::max();
+    }
+};
+
+#endif //THRESHOLD_GRAPH_RANDOM_HPP
@@ -0,0 +1,136 @@
+#include "sampling.hpp"
+
+#include <cmath>
+
+// region PartitionSampler
+
+PartitionSampler::PartitionSampler(unsigned int sum)
+        : partitionSum(sum),
+          logRate(sum > 0 ? -M_PI / sqrt(6.0 * sum) : 0),
+          blockSize(max(1u, (unsigned int) sqrt((double) sum)))
+{}
+
+Partition PartitionSampler::sample(RandomStream& random) const {
+    if (partitionSum == 0) {
+        return Partition({});
+    }
+
+    vector<pair<unsigned int, unsigned int>> multiplicities;
+
+    while (true) {
+        multiplicities.clear();
+        unsigned long long total = 0;
+
+        for (unsigned int blockStart = 2; blockStart <= partitionSum && total <= partitionSum; blockStart += blockSize) {
+            unsigned int blockEnd = min(partitionSum + 1, blockStart + blockSize);
+            double logSkip = log1p(-exp(blockStart * logRate));
+            double part = blockStart - 1;
+
+            while (total <= partitionSum) {
+                part += 1 + floor(log(random.uniform()) / logSkip);
+
+                if (part >= blockEnd) {
+                    break;
+                }
+
+                if (random.uniform() > exp((part - blockStart) * logRate)) {
+                    continue;
+                }
+
+                auto count = (unsigned int) (1 + floor(log(random.uniform()) / (part * logRate)));
+                multiplicities.push_back({(unsigned int) part, count});
+                total += (unsigned long long) part * count;
+            }
+        }
+
+        if (total > partitionSum) {
+            continue;
+        }
+
+        unsigned int ones = partitionSum - (unsigned int) total;
+
+        if (random.uniform() > exp(ones * logRate)) {
+            continue;
+        }
+
+        vector<unsigned int> content;
+
+        for (auto it = multiplicities.rbegin(); it != multiplicities.rend(); ++it) {
+            content.insert(content.end(), it->second, it->first);
+        }
+
+        content.insert(content.end(), ones, 1);
+
+        return Partition(content);
+    }
+}
+
+// endregion
+
+// region GraphDegreeSampler
+
+GraphDegreeSampler::GraphDegreeSampler(unsigned int size, double probability)
+        : graphSize(size), probability(probability)
+{
+    if (probability < 0 || probability > 1) {
+        stringstream message;
+        message << "Edge probability " << probability << " is not in [0, 1].";
+        throw invalid_argument(message.str());
+    }
+}
+
+Partition GraphDegreeSampler::sample(RandomStream& random) const {
+    vector<unsigned int> degrees(graphSize, 0);
+
+    if (probability == 1) {
+        fill(degrees.begin(), degrees.end(), graphSize - 1);
+    }
+    else if (probability == 0.5) {
+        sampleHalf(random, degrees);
+    }
+    else if (probability > 0) {
+        sampleSkipping(random, degrees);
+    }
+
+    return Partition::fromDegrees(degrees);
+}
+
+void GraphDegreeSampler::sampleHalf(RandomStream& random, vector<unsigned int>& degrees) const {
+    for (unsigned int vertex = 1; vertex < graphSize; vertex++) {
+        for (unsigned int first = 0; first < vertex; first += 64) {
+            uint64_t edges = random();
+
+            if (vertex - first < 64) {
+                edges &= (1ull << (vertex - first)) - 1;
+            }
+
+            degrees[vertex] += __builtin_popcountll(edges);
+
+            for (; edges != 0; edges &= edges - 1) {
+                degrees[first + __builtin_ctzll(edges)]++;
+            }
+        }
+    }
+}
+
+void GraphDegreeSampler::sampleSkipping(RandomStream& random, vector<unsigned int>& degrees) const {
+    double logSkip = log1p(-probability);
+    unsigned long long vertex = 1;
+    double other = -1;
+
+    while (vertex < graphSize) {
+        other += 1 + floor(log(random.uniform()) / logSkip);
+
+        while (other >= vertex && vertex < graphSize) {
+            other -= vertex;
+            vertex++;
+        }
+
+        if (vertex < graphSize) {
+            degrees[vertex]++;
+            degrees[(unsigned long long) other]++;
+        }
+    }
+}
+
+// endregion
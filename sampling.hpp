@@ -0,0 +1,43 @@
+#ifndef THRESHOLD_GRAPH_SAMPLING_HPP
+#define THRESHOLD_GRAPH_SAMPLING_HPP
+
+#include "random.hpp"
+#include "partition.hpp"
+
+// Uniform random partitions of a sum by Boltzmann sampling with probabilistic divide-and-conquer.
+// Multiplicities of parts 2..sum are independent geometric variables tuned so the expected sum is the target,
+// ones fill the remainder and the sample is accepted with the probability of that many ones (Arratia, DeSalvo).
+// Parts are drawn block by block with a geometric skip at the block's largest rate and thinning,
+// so a trial costs O(sqrt(sum)) and about sum^(1/4) trials are needed.
+// The sampler is immutable, every thread passes its own random stream.
+class PartitionSampler {
+private:
+    unsigned int partitionSum;
+    double logRate;
+    unsigned int blockSize;
+
+public:
+    explicit PartitionSampler(unsigned int sum);
+
+    Partition sample(RandomStream& random) const;
+};
+
+// Degree partitions of G(n, p) graphs, streaming the edges and keeping only the degrees: O(n) memory, O(n + m) time.
+// Edges are found by geometric skipping over the vertex pairs (Batagelj, Brandes),
+// and for p = 1/2 every random word decides 64 pairs at once.
+class GraphDegreeSampler {
+private:
+    unsigned int graphSize;
+    double probability;
+
+    void sampleHalf(RandomStream& random, vector<unsigned int>& degrees) const;
+
+    void sampleSkipping(RandomStream& random, vector<unsigned int>& degrees) const;
+
+public:
+    GraphDegreeSampler(unsigned int size, double probability);
+
+    Partition sample(RandomStream& random) const;
+};
+
+#endif //THRESHOLD_GRAPH_SAMPLING_HPP
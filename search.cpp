@@ -0,0 +1,32 @@
+#include "search.hpp"
+
+// region MaximumGraphicalPartitionStream
+
+MaximumGraphicalPartitionStream::MaximumGraphicalPartitionStream(const Partition& graphicalPartition, unsigned int threadCount)
+        : pool(threadCount), search(graphicalPartition, pool), nextIndex(0) {}
+
+bool MaximumGraphicalPartitionStream::next(Partition& output, int& distance) {
+    while (nextIndex == levelPartitions.size()) {
+        if (search.isFinished()) {
+            return false;
+        }
+
+        levelPartitions.clear();
+        levelDistances.clear();
+        nextIndex = 0;
+        DistanceRecorder recorder({levelPartitions, levelDistances});
+        search.step(recorder);
+    }
+
+    output = levelPartitions[nextIndex];
+    distance = levelDistances[nextIndex];
+    nextIndex++;
+
+    return true;
+}
+
+SearchStatistics MaximumGraphicalPartitionStream::getStatistics() const {
+    return search.getStatistics();
+}
+
+// endregion
@@ -0,0 +1,334 @@
+#ifndef THRESHOLD_GRAPH_SEARCH_HPP
+#define THRESHOLD_GRAPH_SEARCH_HPP
+
+#include <deque>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "partition.hpp"
+#include "algorithm.hpp"
+#include "parallel.hpp"
+#include "packed.hpp"
+
+using namespace std;
+
+// Search engines over the partition lattice with compile-time policies:
+// Ascendants::generate(partition, output) lists the neighbours,
+// Goal::isGoal(partition) marks results and Goal::STOP_AT_FIRST ends a level search at the first one,
+// the recorder decides what is kept and stops the search by returning false from goal.
+// Policies are plain classes, so every combination is inlined.
+
+// region Policies
+
+struct GraphicalAscendants {
+    static void generate(const Partition& partition, vector<Partition>& output) {
+        partitionGraphicalAscendants(partition, output);
+    }
+};
+
+struct BasicGraphicalAscendants {
+    static void generate(const Partition& partition, vector<Partition>& output) {
+        partitionBasicGraphicalAscendants(partition, output);
+    }
+};
+
+// Maximum graphical partitions have no graphical ascendants, so not expanding goals loses nothing
+template<bool stopAtFirst>
+struct MaximumGraphicalGoal {
+    static const bool STOP_AT_FIRST = stopAtFirst;
+
+    static bool isGoal(const Partition& partition) {
+        return partition.isMaximumGraphical();
+    }
+};
+
+// Goals with their BFS distances
+struct DistanceRecorder {
+    vector<Partition>& partitions;
+    vector<int>& distances;
+
+    bool goal(size_t /*index*/, const Partition& partition, int depth) {
+        partitions.push_back(partition);
+        distances.push_back(depth);
+
+        return true;
+    }
+
+    void child(size_t /*parentIndex*/, const Partition& /*parent*/, const Partition& /*child*/) {}
+
+    void level() {}
+};
+
+// Goals with their distances and nodes of a PartitionNodeStore to restore the chains from
+struct NodeChainRecorder {
+    DistanceRecorder distanceRecorder;
+    PartitionNodeStore& nodes;
+    vector<uint32_t>& goalNodes;
+    vector<uint32_t> frontierNodes;
+    vector<uint32_t> nextFrontierNodes;
+
+    NodeChainRecorder(vector<Partition>& partitions, vector<int>& distances, PartitionNodeStore& nodes, vector<uint32_t>& goalNodes)
+            : distanceRecorder({partitions, distances}), nodes(nodes), goalNodes(goalNodes), frontierNodes({PartitionNodeStore::ROOT}) {}
+
+    bool goal(size_t index, const Partition& partition, int depth) {
+        distanceRecorder.goal(index, partition, depth);
+        goalNodes.push_back(frontierNodes[index]);
+
+        return true;
+    }
+
+    void child(size_t parentIndex, const Partition& parent, const Partition& child) {
+        nextFrontierNodes.push_back(nodes.add(frontierNodes[parentIndex], parent, child));
+    }
+
+    void level() {
+        frontierNodes.swap(nextFrontierNodes);
+        nextFrontierNodes.clear();
+    }
+};
+
+// First parent of every partition, to restore the chain to the first goal
+struct ParentRecorder {
+    unordered_map<Partition, Partition> parent;
+    unique_ptr<Partition> goalPtr;
+
+    bool goal(size_t /*index*/, const Partition& partition, int /*depth*/) {
+        goalPtr.reset(new Partition(partition));
+
+        return true;
+    }
+
+    void child(size_t /*parentIndex*/, const Partition& parent, const Partition& child) {
+        this->parent.insert({child, parent});
+    }
+
+    void level() {}
+};
+
+// Hands every goal to visit(partition, distance) and stops once it returns false
+template<class Visitor>
+struct VisitorRecorder {
+    Visitor& visit;
+    size_t count;
+
+    bool goal(size_t /*index*/, const Partition& partition, int depth) {
+        count++;
+
+        return visit(partition, depth);
+    }
+
+    void child(size_t /*parentIndex*/, const Partition& /*parent*/, const Partition& /*child*/) {}
+
+    void level() {}
+};
+
+// endregion
+
+// region Engines
+
+// Level-synchronous BFS: every level is expanded in parallel, then children are deduplicated
+// against hash-sharded visited sets. Each shard walks the children in level order,
+// so the first parent of every partition and the order of goals match the serial BFS.
+// Moves may skip levels, so children are checked against everything visited so far.
+// The search advances one level per step, so callers can pull results level by level.
+// Visited shards and the frontier keep whole partitions; recorders only decide what is kept besides.
+template<class Ascendants, class Goal>
+class LevelSearch {
+private:
+    ThreadPool& pool;
+    vector<unordered_set<Partition>> visited;
+    vector<Partition> frontier;
+    int depth;
+    SearchStatistics statistics;
+
+public:
+    LevelSearch(const Partition& startPartition, ThreadPool& pool)
+            : pool(pool), visited(pool.size()), frontier({startPartition}), depth(0), statistics({1, 1})
+    {
+        visited[startPartition.hashCode() % visited.size()].insert(startPartition);
+    }
+
+    bool isFinished() const {
+        return frontier.empty();
+    }
+
+    // Records the goals of the current level and expands it, false if the search stopped at a goal
+    template<class Recorder>
+    bool step(Recorder& recorder) {
+        unsigned int shardCount = visited.size();
+        vector<char> isGoal(frontier.size(), 0);
+
+        for (size_t i = 0; i < frontier.size(); i++) {
+            if (!Goal::isGoal(frontier[i])) {
+                continue;
+            }
+
+            isGoal[i] = 1;
+
+            if (!recorder.goal(i, frontier[i], depth) || Goal::STOP_AT_FIRST) {
+                return false;
+            }
+        }
+
+        vector<vector<Partition>> children(frontier.size());
+        vector<vector<size_t>> childShards(frontier.size());
+        vector<vector<char>> isNew(frontier.size());
+
+        pool.parallelFor(frontier.size(), [&](size_t i) {
+            if (!isGoal[i]) {
+                Ascendants::generate(frontier[i], children[i]);
+            }
+
+            childShards[i].reserve(children[i].size());
+
+            for (const auto& child: children[i]) {
+                childShards[i].push_back(child.hashCode() % shardCount);
+            }
+
+            isNew[i].assign(children[i].size(), 0);
+        });
+
+        pool.parallelFor(shardCount, [&](size_t shard) {
+            for (size_t i = 0; i < frontier.size(); i++) {
+                for (size_t j = 0; j < children[i].size(); j++) {
+                    if (childShards[i][j] == shard && visited[shard].insert(children[i][j]).second) {
+                        isNew[i][j] = 1;
+                    }
+                }
+            }
+        });
+
+        vector<Partition> nextFrontier;
+
+        for (size_t i = 0; i < frontier.size(); i++) {
+            for (size_t j = 0; j < children[i].size(); j++) {
+                if (!isNew[i][j]) {
+                    continue;
+                }
+
+                recorder.child(i, frontier[i], children[i][j]);
+                nextFrontier.push_back(move(children[i][j]));
+            }
+        }
+
+        recorder.level();
+        frontier.swap(nextFrontier);
+        depth++;
+        statistics.visitedCount += frontier.size();
+        statistics.peakFrontierSize = max(statistics.peakFrontierSize, frontier.size());
+
+        return true;
+    }
+
+    SearchStatistics getStatistics() const {
+        return statistics;
+    }
+};
+
+template<class Ascendants, class Goal, class Recorder>
+SearchStatistics levelSearch(const Partition& startPartition, ThreadPool& pool, Recorder& recorder) {
+    LevelSearch<Ascendants, Goal> search(startPartition, pool);
+
+    while (!search.isFinished() && search.step(recorder)) {
+    }
+
+    return search.getStatistics();
+}
+
+// Unordered search for when only the set of goals matters: work-stealing workers explore depth first
+// and share a lock-free visited set. Goals of each worker end up in found[worker].
+// A worker that throws raises the failed flag, so the others stop instead of waiting for its queue.
+template<class Ascendants, class Goal>
+SearchStatistics unorderedSearch(const Partition& startPartition, ThreadPool& pool, vector<vector<Partition>>& found) {
+    unsigned int workerCount = pool.size();
+    ConcurrentPartitionSet visited;
+    WorkStealingQueue queue(workerCount);
+    atomic<bool> failed(false);
+    found.assign(workerCount, vector<Partition>());
+
+    visited.insert(startPartition);
+    queue.push(0, startPartition);
+
+    pool.parallelFor(workerCount, [&](size_t worker) {
+        Partition partition(startPartition);
+        vector<Partition> ascendants;
+
+        try {
+            while (!failed) {
+                if (!queue.pop(worker, partition)) {
+                    if (queue.isFinished()) {
+                        break;
+                    }
+
+                    this_thread::yield();
+                    continue;
+                }
+
+                if (Goal::isGoal(partition)) {
+                    found[worker].push_back(partition);
+                }
+                else {
+                    ascendants.clear();
+                    Ascendants::generate(partition, ascendants);
+
+                    for (const auto& child: ascendants) {
+                        if (visited.insert(child)) {
+                            queue.push(worker, child);
+                        }
+                    }
+                }
+
+                queue.finish();
+            }
+        }
+        catch (...) {
+            failed = true;
+            throw;
+        }
+    });
+
+    return {visited.size(), queue.peakSize()};
+}
+
+// Calls visit(partition, distance) for the maximum graphical partitions reachable from the start
+// in the order of PartitionSearchAlgorithm, as soon as their level is reached, until visit returns false.
+// Returns the number of partitions visited.
+template<class Visitor>
+size_t forEachMaximumGraphicalPartition(const Partition& startPartition, Visitor visit, unsigned int threadCount = 1) {
+    ThreadPool pool(threadCount);
+    VisitorRecorder<Visitor> recorder({visit, 0});
+    levelSearch<BasicGraphicalAscendants, MaximumGraphicalGoal<false>>(startPartition, pool, recorder);
+
+    return recorder.count;
+}
+
+// endregion
+
+// Pulls the maximum graphical partitions reachable from a partition one at a time,
+// in the order of PartitionSearchAlgorithm. Levels are pulled with one level of lookahead:
+// once the results of a level are taken, next() records the goals of the following level
+// and expands it in the same step, so the frontier one level past any returned result
+// is already generated and held. A caller stopping early still skips the levels beyond that
+// and never holds all the results.
+class MaximumGraphicalPartitionStream {
+private:
+    ThreadPool pool;
+    LevelSearch<BasicGraphicalAscendants, MaximumGraphicalGoal<false>> search;
+    vector<Partition> levelPartitions;
+    vector<int> levelDistances;
+    size_t nextIndex;
+
+public:
+    explicit MaximumGraphicalPartitionStream(const Partition& graphicalPartition, unsigned int threadCount = 1);
+
+    MaximumGraphicalPartitionStream(const MaximumGraphicalPartitionStream& other) = delete;
+
+    MaximumGraphicalPartitionStream& operator=(const MaximumGraphicalPartitionStream& other) = delete;
+
+    bool next(Partition& output, int& distance);
+
+    SearchStatistics getStatistics() const;
+};
+
+#endif //THRESHOLD_GRAPH_SEARCH_HPP
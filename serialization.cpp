@@ -0,0 +1,361 @@
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <climits>
+
+static const char MAGIC[] = {'L', 'G', 'P', 'B'};
+
+enum TransitionType {
+    INSERT_TRANSITION = 0,
+    MOVE_TRANSITION = 1,
+    REMOVE_TRANSITION = 2
+};
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+// region BinaryWriter
+
+BinaryWriter::BinaryWriter(ostream& stream, bool writeHeader) : stream(stream) {
+    if (writeHeader) {
+        stream.write(MAGIC, sizeof(MAGIC));
+        writeByte(VERSION);
+    }
+}
+
+void BinaryWriter::writeByte(uint8_t value) {
+    stream.put((char) value);
+}
+
+void BinaryWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        writeByte((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+
+    writeByte((uint8_t) value);
+}
+
+void BinaryWriter::writeContent(const Partition& partition) {
+    int length = partition.length();
+    writeVarint(length);
+
+    if (length == 0) {
+        return;
+    }
+
+    writeVarint(partition[length - 1]);
+
+    for (int i = length - 2; i >= 0; i--) {
+        if (partition[i] < partition[i + 1]) {
+            stringstream message;
+            message << "Partition '" << partition << "' is not sorted and can't be written.";
+            throw invalid_argument(message.str());
+        }
+
+        writeVarint(partition[i] - partition[i + 1]);
+    }
+}
+
+void BinaryWriter::writeDelta(const Partition& from, const Partition& to) {
+    int maxLength = max(from.length(), to.length());
+    vector<pair<int, int64_t>> changes;
+
+    for (int i = 0; i < maxLength; i++) {
+        if (from[i] != to[i]) {
+            changes.emplace_back(i, (int64_t) to[i] - (int64_t) from[i]);
+        }
+    }
+
+    writeVarint(changes.size());
+    int previousColumn = 0;
+
+    for (const auto& change: changes) {
+        writeVarint(change.first - previousColumn);
+        writeVarint(zigzag(change.second));
+        previousColumn = change.first;
+    }
+}
+
+template <typename Iterator>
+void BinaryWriter::writeSequence(Iterator begin, Iterator end, size_t count) {
+    writeByte(SEQUENCE_RECORD);
+    writeVarint(count);
+
+    if (begin == end) {
+        return;
+    }
+
+    writeContent(*begin);
+
+    for (auto previous = begin++; begin != end; previous = begin++) {
+        writeDelta(*previous, *begin);
+    }
+}
+
+void BinaryWriter::write(const Partition& partition) {
+    writeByte(PARTITION_RECORD);
+    writeContent(partition);
+}
+
+void BinaryWriter::write(const deque<Partition>& partitions) {
+    writeSequence(partitions.begin(), partitions.end(), partitions.size());
+}
+
+void BinaryWriter::write(const vector<Partition>& partitions) {
+    writeSequence(partitions.begin(), partitions.end(), partitions.size());
+}
+
+void BinaryWriter::write(TransitionChain& chain) {
+    writeByte(CHAIN_RECORD);
+    writeVarint(chain.length());
+
+    for (int i = 0; i < chain.length(); i++) {
+        const PartitionTransition& transition = chain[i];
+
+        if (transition.isInsert()) {
+            writeVarint((uint64_t) transition.insertColumn() << 2 | INSERT_TRANSITION);
+            writeVarint(transition.insertRow());
+        }
+        else if (transition.isMove()) {
+            writeVarint((uint64_t) transition.removeColumn() << 2 | MOVE_TRANSITION);
+            writeVarint(transition.removeRow());
+            writeVarint(transition.insertColumn());
+            writeVarint(transition.insertRow());
+        }
+        else {
+            writeVarint((uint64_t) transition.removeColumn() << 2 | REMOVE_TRANSITION);
+            writeVarint(transition.removeRow());
+        }
+    }
+}
+
+void BinaryWriter::write(const SearchResult& result) {
+    writeByte(RESULT_RECORD);
+    writeVarint(result.query);
+    writeContent(result.start);
+    writeVarint(result.partitions.size());
+
+    for (size_t i = 0; i < result.partitions.size(); i++) {
+        writeVarint((uint64_t) result.distances[i]);
+        writeContent(result.partitions[i]);
+    }
+}
+
+void BinaryWriter::flush() {
+    stream.flush();
+}
+
+// endregion
+
+// region BinaryReader
+
+BinaryReader::BinaryReader(istream& stream) : stream(stream) {
+    char magic[sizeof(MAGIC)];
+
+    if (!stream.read(magic, sizeof(MAGIC)) || !equal(magic, magic + sizeof(MAGIC), MAGIC)) {
+        throw runtime_error("Stream is not in limit graph binary format.");
+    }
+
+    version = readByte();
+
+    if (version > BinaryWriter::VERSION) {
+        stringstream message;
+        message << "Unsupported binary format version " << (int) version << ".";
+        throw runtime_error(message.str());
+    }
+}
+
+uint8_t BinaryReader::readByte() {
+    int value = stream.get();
+
+    if (value == char_traits<char>::eof()) {
+        throw runtime_error("Unexpected end of binary stream.");
+    }
+
+    return (uint8_t) value;
+}
+
+uint64_t BinaryReader::readVarint() {
+    uint64_t result = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t value = readByte();
+        result |= (uint64_t) (value & 0x7f) << shift;
+
+        if ((value & 0x80) == 0) {
+            return result;
+        }
+    }
+
+    throw runtime_error("Malformed varint in binary stream.");
+}
+
+uint64_t BinaryReader::remainingBytes() {
+    streambuf* buffer = stream.rdbuf();
+    streampos position = buffer->pubseekoff(0, ios_base::cur, ios_base::in);
+
+    if (position == streampos(-1)) {
+        return UINT64_MAX;
+    }
+
+    streampos end = buffer->pubseekoff(0, ios_base::end, ios_base::in);
+    buffer->pubseekpos(position, ios_base::in);
+
+    return end == streampos(-1) ? UINT64_MAX : (uint64_t) (end - position);
+}
+
+vector<unsigned int> BinaryReader::readContent() {
+    uint64_t length = readVarint();
+
+    // Every column takes at least one byte, so a longer length can only come from a corrupt stream
+    if (length > UINT_MAX || length > remainingBytes()) {
+        stringstream message;
+        message << "Partition length " << length << " in binary stream exceeds the remaining data.";
+        throw runtime_error(message.str());
+    }
+
+    // Columns are collected as they are read, so a stream that can't tell its size still can't force
+    // a larger allocation than the bytes it holds
+    vector<unsigned int> content;
+
+    for (uint64_t i = 0; i < length; i++) {
+        content.push_back((unsigned int) readVarint() + (content.empty() ? 0 : content.back()));
+    }
+
+    reverse(content.begin(), content.end());
+
+    return content;
+}
+
+void BinaryReader::readDelta(vector<unsigned int>& content) {
+    uint64_t changes = readVarint();
+    uint64_t column = 0;
+
+    for (uint64_t i = 0; i < changes; i++) {
+        column += readVarint();
+        int64_t difference = unzigzag(readVarint());
+
+        // Changed columns come in order and a longer partition changes every new column
+        if (column > content.size()) {
+            stringstream message;
+            message << "Changed column " << column << " in binary stream is past the partition end.";
+            throw runtime_error(message.str());
+        }
+
+        if (column == content.size()) {
+            content.resize(column + 1, 0);
+        }
+
+        content[column] = (unsigned int) (content[column] + difference);
+    }
+
+    while (!content.empty() && content.back() == 0) {
+        content.pop_back();
+    }
+}
+
+void BinaryReader::expect(RecordType type) {
+    RecordType actual = next();
+
+    if (actual != type) {
+        stringstream message;
+        message << "Expected binary record of type " << type << " but found " << actual << ".";
+        throw runtime_error(message.str());
+    }
+
+    stream.get();
+}
+
+RecordType BinaryReader::next() {
+    int value = stream.peek();
+
+    if (value == char_traits<char>::eof()) {
+        return END_OF_STREAM;
+    }
+
+    if (value < PARTITION_RECORD || value > RESULT_RECORD) {
+        stringstream message;
+        message << "Unknown binary record type " << value << ".";
+        throw runtime_error(message.str());
+    }
+
+    return (RecordType) value;
+}
+
+Partition BinaryReader::readPartition() {
+    expect(PARTITION_RECORD);
+    return Partition(readContent());
+}
+
+deque<Partition> BinaryReader::readSequence() {
+    expect(SEQUENCE_RECORD);
+    uint64_t count = readVarint();
+    deque<Partition> result;
+
+    if (count == 0) {
+        return result;
+    }
+
+    vector<unsigned int> content = readContent();
+    result.emplace_back(content);
+
+    for (uint64_t i = 1; i < count; i++) {
+        readDelta(content);
+        result.emplace_back(content);
+    }
+
+    return result;
+}
+
+TransitionChain BinaryReader::readChain() {
+    expect(CHAIN_RECORD);
+    uint64_t count = readVarint();
+    TransitionChain result;
+
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t packed = readVarint();
+        auto column = (int) (packed >> 2);
+
+        switch (packed & 3) {
+            case INSERT_TRANSITION:
+                result.push_back(new PartitionInsert(column, (int) readVarint()));
+                break;
+            case MOVE_TRANSITION: {
+                auto fromRow = (int) readVarint();
+                auto toColumn = (int) readVarint();
+                auto toRow = (int) readVarint();
+                result.push_back(new PartitionMove(column, fromRow, toColumn, toRow));
+                break;
+            }
+            case REMOVE_TRANSITION:
+                result.push_back(new PartitionRemove(column, (int) readVarint()));
+                break;
+            default:
+                throw runtime_error("Unknown transition type in binary stream.");
+        }
+    }
+
+    return result;
+}
+
+SearchResult BinaryReader::readResult() {
+    expect(RESULT_RECORD);
+    uint64_t query = readVarint();
+    SearchResult result = {query, Partition(readContent()), {}, {}};
+    uint64_t count = readVarint();
+
+    for (uint64_t i = 0; i < count; i++) {
+        result.distances.push_back((int) readVarint());
+        result.partitions.emplace_back(readContent());
+    }
+
+    return result;
+}
+
+// endregion
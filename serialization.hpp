@@ -0,0 +1,102 @@
+#ifndef THRESHOLD_GRAPH_SERIALIZATION_HPP
+#define THRESHOLD_GRAPH_SERIALIZATION_HPP
+
+#include <istream>
+#include <ostream>
+#include "partition.hpp"
+#include "transition.hpp"
+
+// Binary result format: a header followed by independent records, so files of any size can be
+// written and read back one record at a time.
+//
+// Header:    "LGPB" <version byte>
+// Record:    <type byte> <payload>
+// Partition: varint length, then the last column and the differences between neighbouring columns
+// Sequence:  varint count, the first partition, then for every next partition the changed columns
+//            as (varint column gap, zigzag varint difference) pairs
+// Chain:     varint count, then for every transition varint (column << 2 | type) and the other coordinates
+// Result:    varint query, the start partition, varint count, then varint distance and partition for every result
+
+enum RecordType {
+    END_OF_STREAM = 0,
+    PARTITION_RECORD = 1,
+    SEQUENCE_RECORD = 2,
+    CHAIN_RECORD = 3,
+    RESULT_RECORD = 4
+};
+
+// Maximum graphical partitions found above a start partition with their distances
+struct SearchResult {
+    uint64_t query;
+    Partition start;
+    vector<Partition> partitions;
+    vector<int> distances;
+};
+
+class BinaryWriter {
+private:
+    ostream& stream;
+
+    void writeByte(uint8_t value);
+
+    void writeVarint(uint64_t value);
+
+    void writeContent(const Partition& partition);
+
+    void writeDelta(const Partition& from, const Partition& to);
+
+    template <typename Iterator>
+    void writeSequence(Iterator begin, Iterator end, size_t count);
+
+public:
+    static const uint8_t VERSION = 1;
+
+    // Without the header the records can be appended to a stream another writer started
+    explicit BinaryWriter(ostream& stream, bool writeHeader = true);
+
+    void write(const Partition& partition);
+
+    void write(const deque<Partition>& partitions);
+
+    void write(const vector<Partition>& partitions);
+
+    void write(TransitionChain& chain);
+
+    void write(const SearchResult& result);
+
+    void flush();
+};
+
+class BinaryReader {
+private:
+    istream& stream;
+    uint8_t version;
+
+    uint8_t readByte();
+
+    uint64_t readVarint();
+
+    // Bytes left in a seekable stream, UINT64_MAX when the stream can't tell
+    uint64_t remainingBytes();
+
+    vector<unsigned int> readContent();
+
+    void readDelta(vector<unsigned int>& content);
+
+    void expect(RecordType type);
+
+public:
+    explicit BinaryReader(istream& stream);
+
+    RecordType next();
+
+    Partition readPartition();
+
+    deque<Partition> readSequence();
+
+    TransitionChain readChain();
+
+    SearchResult readResult();
+};
+
+#endif //THRESHOLD_GRAPH_SERIALIZATION_HPP
@@ -9,6 +9,7 @@ void LimitGraphTest::all() {
     LimitGraphTest::graph();
     LimitGraphTest::transition();
     LimitGraphTest::algorithm();
+    LimitGraphTest::serialization();
 }
 
 void LimitGraphTest::partition() {
@@ -99,6 +100,30 @@ void LimitGraphTest::partition() {
     assert(partition.isValid());
     assert(partition == Partition({4, 2, 2, 1, 1}));
 
+    assert(Partition({4, 2, 2, 1, 1, 1, 1}).maximumGraphical() == Partition({4, 3, 2, 2, 1}));
+    assert(Partition({3, 3, 2, 1, 1, 1, 1}).maximumGraphical() == Partition({4, 3, 2, 2, 1}));
+    assert(Partition({3, 3, 2, 2}).maximumGraphical() == Partition({3, 3, 2, 2}));
+    assert(Partition::from(10, 1).maximumGraphical() == Partition({5, 1, 1, 1, 1, 1}));
+    assert(Partition({}).maximumGraphical() == Partition({}));
+
+    for (int i = 0; i < 20; i++) {
+        RandomStream random(i);
+        partition = *randomGraphPartitionPtr(30, random);
+        Partition maximum = partition.maximumGraphical();
+        ColoredPartition coloredMaximum(partition);
+        coloredMaximum.maximize();
+
+        assert(maximum.isValid());
+        assert(maximum.isMaximumGraphical());
+        assert(maximum >= partition);
+        assert(coloredMaximum.isValid());
+        assert(coloredMaximum == ColoredPartition(coloredMaximum));
+
+        for (int j = 0; j < maximum.length(); j++) {
+            assert(coloredMaximum[j] == maximum[j]);
+        }
+    }
+
     partition = Partition::from(Graph(
             {{0, 1, 0, 0},
              {1, 0, 1, 0},
@@ -419,6 +444,37 @@ void LimitGraphTest::partition() {
     assert(cpartition.isValid());
     assert(cpartition == expectedCpartition);
 
+    cpartition = ColoredPartition({40, 40, 1});
+    cpartition.paintHeadBlack();
+
+    assert(cpartition.isValid());
+    assert(cpartition.getColor(0, 0) == NONE);
+    assert(cpartition.getColor(0, 1) == BLACK);
+    assert(cpartition.getColor(0, 31) == BLACK);
+    assert(cpartition.getColor(0, 32) == BLACK);
+    assert(cpartition.getColor(1, 39) == BLACK);
+    assert(cpartition.getColor(1, 40) == NONE);
+    assert(cpartition.getColor(2, 0) == NONE);
+
+    cpartition.move(2, 0);
+
+    assert(cpartition.isValid());
+    assert(cpartition.getColor(0) == NONE);
+    assert(cpartition.getColor(2, 0) == NONE);
+
+    cpartition.paint(GREY, 0);
+    cpartition.insert(5);
+    cpartition.paint(GREY, 5);
+
+    assert(cpartition.getColor(0, 40) == GREY);
+    assert(cpartition.getColor(5, 0) == GREY);
+    assert(!cpartition.isValid());
+
+    cpartition.remove(5);
+
+    assert(cpartition.isValid());
+    assert(cpartition == ColoredPartition(cpartition));
+
     // endregion
 
     // region Comparison
@@ -532,6 +588,34 @@ void LimitGraphTest::graph() {
     graph = Graph(adjacencyMatrix);
     graph.connect(0, 2);
     assert(graph.isLimit());
+
+    // Degrees follow every change, repeated ones included
+    graph.connect(0, 2);
+    graph.disconnect(1, 3);
+    assert(graph.deg(0) == 2 && graph.deg(1) == 2 && graph.deg(2) == 3 && graph.deg(3) == 1);
+    graph.disconnect(0, 1);
+    graph.disconnect(0, 1);
+    assert(graph.deg(0) == 1 && graph.deg(1) == 1);
+
+    // Readers share one graph
+    RandomStream random(7);
+    const Graph sharedGraph = *randomGraphPtr(40, random);
+    unique_ptr<Triple> expectedTriple = sharedGraph.maxIncreasingTriplePtr();
+    ThreadPool pool(4);
+    atomic<int> mismatches(0);
+
+    pool.parallelFor(16, [&](size_t i) {
+        unique_ptr<Triple> triple = sharedGraph.maxIncreasingTriplePtr();
+
+        if ((triple == nullptr) != (expectedTriple == nullptr) || sharedGraph.isLimit() != (expectedTriple == nullptr)) {
+            mismatches++;
+        }
+        else if (triple != nullptr && (triple->x != expectedTriple->x || !sharedGraph.isIncreasingTriple(triple.get()))) {
+            mismatches++;
+        }
+    });
+
+    assert(mismatches == 0);
 }
 
 void LimitGraphTest::transition() {
@@ -650,31 +734,118 @@ void LimitGraphTest::transition() {
                                     });
 
     assert(chain.conjugate() == expectedChain);
+
+    vector<Partition> partitions = {Partition({4, 2, 1}), Partition({5, 3, 2}), Partition({3, 2, 1})};
+    PartitionBatch batch(partitions);
+
+    assert(batch.isValid());
+    assert(batch.size() == 3);
+    assert(batch[1] == Partition({5, 3, 2}));
+
+    chain = TransitionChain({
+                                    new PartitionMove(2, 0, 0, 4),
+                                    new PartitionInsert(2, 0),
+                                    new PartitionRemove(1, 1)
+                            });
+    batch = PartitionBatch(partitions);
+    chain.apply(batch);
+
+    for (int i = 0; i < partitions.size(); i++) {
+        chain.apply(partitions[i]);
+        assert(batch[i] == partitions[i]);
+    }
+
+    bool thrown = false;
+    batch = PartitionBatch({Partition({2}), Partition({1, 1})});
+
+    try {
+        TransitionChain({new PartitionMove(1, 0, 0, 1)}).apply(batch);
+    }
+    catch (runtime_error& error) {
+        thrown = true;
+    }
+
+    assert(thrown);
 }
 
+// Graphical ascendants that fail once the search is well under way, when every worker is busy
+struct FailingAscendants {
+    static atomic<int> calls;
+
+    static void generate(const Partition& partition, vector<Partition>& output) {
+        if (++calls == 300) {
+            throw runtime_error("Failed expansion.");
+        }
+
+        partitionGraphicalAscendants(partition, output);
+    }
+};
+
+atomic<int> FailingAscendants::calls(0);
+
 void LimitGraphTest::algorithm() {
     // region Randomize
 
     for(int i = 0; i < 100; i++) {
-        srand(i);
-        cout << *randomPartitionPtr(10) << endl;
+        RandomStream random(i);
+        cout << *randomPartitionPtr(10, random) << endl;
     }
 
-    Partition partition = *randomPartitionPtr(10);
+    RandomStream random(0);
+    uint64_t first = random();
+    uint64_t second = random();
+
+    // Philox4x32-10 known answer for zero key and counter
+    assert(first == 0xe169c58d6627e8d5ull);
+    assert(second == 0x9b00dbd8bc57ac4cull);
+    assert(random.counter() == 1);
+    assert(RandomStream(0, 0, 1)() == random());
+    assert(random.split(1)() == random.split(1)());
+    assert(random.split(1)() != random.split(2)());
+    assert(random.uniform() > 0 && random.uniform() <= 1);
+
+    Partition partition = *randomPartitionPtr(10, random);
 
     assert(partition.isValid());
 
-    partition = *randomPartitionPtr(100);
+    partition = *randomPartitionPtr(100, random);
 
     assert(partition.isValid());
 
-    partition = *randomPartitionPtr(1000);
+    partition = *randomPartitionPtr(1000, random);
 
     assert(partition.isValid());
 
-    partition = *randomPartitionPtr(2000);
+    partition = *randomPartitionPtr(2000, random);
 
     assert(partition.isValid());
+    assert(partition.sum() == 2000);
+
+    // Every one of the 11 partitions of 6 is drawn about equally often
+    PartitionSampler sampler(6);
+    unordered_map<Partition, int> sampleCounts;
+
+    for (int i = 0; i < 11000; i++) {
+        sampleCounts[sampler.sample(random)]++;
+    }
+
+    assert(sampleCounts.size() == 11);
+
+    for (const auto& sampleCount: sampleCounts) {
+        assert(sampleCount.second > 800 && sampleCount.second < 1200);
+    }
+
+    assert(GraphDegreeSampler(7, 1).sample(random) == Partition::from(7, 6));
+    assert(GraphDegreeSampler(7, 0).sample(random) == Partition({}));
+
+    for (double probability: {0.5, 0.01}) {
+        partition = GraphDegreeSampler(2000, probability).sample(random);
+        double expectedSum = probability * 2000 * 1999;
+
+        assert(partition.isGraphical());
+        assert(partition.length() <= 2000);
+        assert(abs(partition.sum() - expectedSum) < 0.05 * expectedSum);
+    }
 
     // endregion
 
@@ -803,6 +974,60 @@ void LimitGraphTest::algorithm() {
 
     assertIgnore(*actualPartitionChainPtr == expectedPartitionChain);
 
+    assert(maximizingMovesLowerBound(Partition::from(10, 1)) == 4);
+    assert(maximizingMovesLowerBound(Partition({4, 2, 2, 1, 1, 1, 1})) == 1);
+    assert(maximizingMovesLowerBound(Partition({3, 3, 2, 2})) == 0);
+
+    actualPartitionChainPtr = findShortestMaximizingChainPtr(Partition::from(10, 1), A_STAR);
+
+    assert(*actualPartitionChainPtr == *findShortestMaximizingChainPtr(Partition::from(10, 1)));
+
+    vector<Partition> neighbours;
+
+    // Targets built without the trailing zero columns the search produces
+    partition = Partition({1, 1, 1, 1});
+    assert(findShortestMaximizingChainPtr(partition, {partition.maximumGraphical()})->back() == Partition({2, 1, 1}));
+
+    for (int i = 0; i < 10; i++) {
+        RandomStream random(i + 100);
+        partition = *randomGraphPartitionPtr(9, random);
+        ColoredPartition coloredMaximum(partition);
+        coloredMaximum.maximize();
+        vector<unsigned int> coloredColumns;
+
+        for (unsigned int j = 0; j < coloredMaximum.length(); j++) {
+            coloredColumns.push_back(coloredMaximum[j]);
+        }
+
+        Partition maximum = partition.maximumGraphical();
+
+        assert(findShortestMaximizingChainPtr(partition, {maximum})->back() == maximum);
+        assert(findShortestMaximizingChainPtr(partition, {Partition(coloredColumns)})->back() == maximum);
+    }
+
+    for (int i = 0; i < 10; i++) {
+        RandomStream random(i);
+        partition = *randomGraphPartitionPtr(8, random);
+        deque<Partition> breadthFirstChain = *findShortestMaximizingChainPtr(partition);
+        deque<Partition> aStarChain = *findShortestMaximizingChainPtr(partition, A_STAR);
+        deque<Partition> bidirectionalChain = *findShortestMaximizingChainPtr(partition, *findMaximumGraphicalPartitionsPtr(partition));
+
+        assert(aStarChain.size() == breadthFirstChain.size());
+        assert(bidirectionalChain.size() == breadthFirstChain.size());
+        assert(bidirectionalChain.front() == partition);
+        assert(bidirectionalChain.back().isMaximumGraphical());
+
+        for (int j = 1; j < bidirectionalChain.size(); j++) {
+            neighbours.clear();
+            partitionGraphicalAscendants(bidirectionalChain[j - 1], neighbours);
+            assert(find(neighbours.begin(), neighbours.end(), bidirectionalChain[j]) != neighbours.end());
+
+            neighbours.clear();
+            partitionGraphicalDescendants(bidirectionalChain[j], neighbours);
+            assert(find(neighbours.begin(), neighbours.end(), bidirectionalChain[j - 1]) != neighbours.end());
+        }
+    }
+
     // endregion
 
     //region Search
@@ -898,6 +1123,174 @@ void LimitGraphTest::algorithm() {
 
     assert(actualMGPsPtr.size() == 0);
 
+    // MGP7
+    partition = Partition::from(16, 1);
+
+    assert(*findMaximumGraphicalPartitionsPtr(partition, 4) == *findMaximumGraphicalPartitionsPtr(partition));
+
+    SearchStatistics statistics = {0, 0};
+    actualMGPsPtr = *findMaximumGraphicalPartitionsPtr(partition, 1, &statistics);
+
+    assert(statistics.visitedCount > 0);
+    assert(statistics.peakFrontierSize > 0);
+    assert(statistics.peakFrontierSize <= statistics.visitedCount);
+
+    // MGP8
+    ReachableMaximumCache cache;
+    vector<Partition> queries({Partition::from(14, 1), Partition({3, 2, 1, 1, 1, 1, 1}), Partition::from(12, 1)});
+
+    for (const auto& query: queries) {
+        assert(*cache.findMaximumGraphicalPartitionsPtr(query) == *findMaximumGraphicalPartitionsPtr(query));
+    }
+
+    size_t cachedCount = cache.size();
+
+    assert(*cache.findMaximumGraphicalPartitionsPtr(queries[0]) == *findMaximumGraphicalPartitionsPtr(queries[0]));
+    assert(cache.size() == cachedCount);
+    assert(cache.maximumCount() >= findMaximumGraphicalPartitionsPtr(queries[0])->size());
+
+    for (const auto& query: queries) {
+        PartitionSearchAlgorithm queryCheck(query);
+        vector<Partition> expectedMaximums = *queryCheck.getPartitions();
+        vector<int> expectedMaximumDistances = *queryCheck.getDistances();
+        vector<Partition> cachedMaximums;
+        vector<int> cachedDistances;
+        cache.findMaximumGraphicalPartitions(query, cachedMaximums, cachedDistances);
+
+        assert(cachedMaximums.size() == expectedMaximums.size());
+        assert(is_sorted(cachedDistances.begin(), cachedDistances.end()));
+
+        for (int i = 0; i < cachedMaximums.size(); i++) {
+            auto found = find(expectedMaximums.begin(), expectedMaximums.end(), cachedMaximums[i]);
+
+            assert(expectedMaximumDistances[found - expectedMaximums.begin()] == cachedDistances[i]);
+        }
+    }
+
+    // A warm cache answers every graphical partition of 12 as a fresh one does
+    ReachableMaximumCache warmCache;
+    Partition graphicalPartition({1});
+
+    for (PartitionEnumerator graphicalEnumerator(12, true); graphicalEnumerator.next(graphicalPartition); ) {
+        ReachableMaximumCache coldCache;
+        vector<Partition> warmMaximums, coldMaximums;
+        vector<int> warmDistances, coldDistances;
+        warmCache.findMaximumGraphicalPartitions(graphicalPartition, warmMaximums, warmDistances);
+        coldCache.findMaximumGraphicalPartitions(graphicalPartition, coldMaximums, coldDistances);
+
+        assert(warmMaximums == coldMaximums);
+        assert(warmDistances == coldDistances);
+    }
+
+    assert(Partition({2, 1, 0}).hashCode() == Partition({2, 1}).hashCode());
+
+    // Ties don't depend on what the cache saw before
+    Partition tiedQuery({4, 2, 2, 2, 2, 1, 1, 1, 1});
+    ReachableMaximumCache freshCache;
+    ReachableMaximumCache primedCache;
+    vector<Partition> freshMaximums, primedMaximums;
+    vector<int> freshDistances, primedDistances;
+    primedCache.findMaximumGraphicalPartitionsPtr(Partition({8, 1, 1, 1, 1, 1, 1, 1, 1}));
+    freshCache.findMaximumGraphicalPartitions(tiedQuery, freshMaximums, freshDistances);
+    primedCache.findMaximumGraphicalPartitions(tiedQuery, primedMaximums, primedDistances);
+
+    assert(freshMaximums == primedMaximums);
+    assert(freshDistances == primedDistances);
+
+    // Session batches, one cache per thread, against the warm single cache
+    LimitGraphSession session(2);
+    vector<Partition> batch = session.randomGraphPartitions(8, 5, 6);
+    batch.insert(batch.end(), queries.begin(), queries.end());
+
+    assert(batch[0] == session.randomGraphPartitions(8, 5, 1)[0]);
+
+    vector<SearchResult> batchResults = session.findMaximumGraphicalPartitions(batch);
+    vector<SearchResult> warmResults = session.findMaximumGraphicalPartitions(batch);
+
+    assert(batchResults.size() == batch.size());
+    assert(session.cacheSize() > 0);
+
+    for (int i = 0; i < batch.size(); i++) {
+        vector<Partition> cachedMaximums;
+        vector<int> cachedDistances;
+        cache.findMaximumGraphicalPartitions(batch[i], cachedMaximums, cachedDistances);
+
+        assert(batchResults[i].query == i);
+        assert(batchResults[i].start == batch[i]);
+        assert(batchResults[i].partitions == cachedMaximums);
+        assert(batchResults[i].distances == cachedDistances);
+        assert(warmResults[i].partitions == cachedMaximums);
+    }
+
+    // Larger queries share more territory, the order must not follow the cache history
+    vector<Partition> largerBatch = session.randomGraphPartitions(10, 9, 6);
+    vector<SearchResult> largerResults = session.findMaximumGraphicalPartitions(largerBatch);
+    ReachableMaximumCache reversedCache;
+
+    for (int i = largerBatch.size() - 1; i >= 0; i--) {
+        reversedCache.findMaximumGraphicalPartitionsPtr(largerBatch[i]);
+    }
+
+    for (int i = 0; i < largerBatch.size(); i++) {
+        vector<Partition> cachedMaximums;
+        vector<int> cachedDistances;
+        reversedCache.findMaximumGraphicalPartitions(largerBatch[i], cachedMaximums, cachedDistances);
+
+        assert(largerResults[i].partitions == cachedMaximums);
+        assert(largerResults[i].distances == cachedDistances);
+    }
+
+    // A session warmed by other batches answers like a fresh one, whichever thread's cache is used
+    vector<Partition> graphicalOf14;
+
+    for (PartitionEnumerator enumerator14(14, true); enumerator14.next(graphicalPartition); ) {
+        graphicalOf14.push_back(graphicalPartition);
+    }
+
+    LimitGraphSession warmSession(3);
+    warmSession.findMaximumGraphicalPartitions(vector<Partition>(graphicalOf14.rbegin(), graphicalOf14.rend()));
+    vector<SearchResult> warmSessionResults = warmSession.findMaximumGraphicalPartitions(graphicalOf14);
+    vector<SearchResult> freshSessionResults = LimitGraphSession(2).findMaximumGraphicalPartitions(graphicalOf14);
+
+    for (int i = 0; i < graphicalOf14.size(); i++) {
+        assert(warmSessionResults[i].partitions == freshSessionResults[i].partitions);
+        assert(warmSessionResults[i].distances == freshSessionResults[i].distances);
+    }
+
+    // Batch answers over every graphical partition of 16 match fresh per-query answers byte for byte
+    stringstream batchInput, batchOutput, batchErrors;
+    string expectedBatchOutput;
+    ResultFormatter csvFormatter(CSV_FORMAT);
+    LimitGraphSession batchSession(1);
+    uint64_t batchQuery = 0;
+
+    for (PartitionEnumerator batchEnumerator(16, true); batchEnumerator.next(graphicalPartition); batchQuery++) {
+        ReachableMaximumCache freshQueryCache;
+        SearchResult expectedResult = {batchQuery, graphicalPartition, {}, {}};
+        freshQueryCache.findMaximumGraphicalPartitions(graphicalPartition, expectedResult.partitions, expectedResult.distances);
+        expectedBatchOutput += csvFormatter.format(expectedResult);
+
+        for (unsigned int i = 0; i < graphicalPartition.length(); i++) {
+            batchInput << graphicalPartition[i] << " ";
+        }
+
+        batchInput << "\n";
+    }
+
+    batchInput << "\n3 x\n";
+    batchSession.answerQueries(batchInput, batchOutput, batchErrors, csvFormatter);
+
+    assert(batchQuery == 90);
+    assert(batchOutput.str() == expectedBatchOutput);
+    assert(batchErrors.str() == "Query 90: expected positive integers, got \"3 x\"\n");
+
+    try {
+        session.findMaximumGraphicalPartitions({Partition({3, 1})});
+        assert(false);
+    }
+    catch (const invalid_argument&) {
+    }
+
     // PSA1
     difference.clear();
     partition = Partition({3, 2, 1, 1, 1, 1, 1});
@@ -961,8 +1354,389 @@ void LimitGraphTest::algorithm() {
         }
     }
 
+    // PSA3
+    partition = Partition::from(14, 1);
+    PartitionSearchAlgorithm serialSearch(partition);
+    PartitionSearchAlgorithm parallelSearch(partition, 4);
+
+    assert(*serialSearch.getPartitions() == *parallelSearch.getPartitions());
+    assert(*serialSearch.getDistances() == *parallelSearch.getDistances());
+    assert(serialSearch.getStatistics().visitedCount == parallelSearch.getStatistics().visitedCount);
+    assert(serialSearch.getStatistics().peakFrontierSize == parallelSearch.getStatistics().peakFrontierSize);
+    assert(serialSearch.getStatistics().peakFrontierSize < serialSearch.getStatistics().visitedCount);
+
+    stringstream orderedOutput;
+    string expectedOutput;
+
+    {
+        ThreadPool pool(4);
+        OrderedWriter writer(orderedOutput, 2);
+
+        pool.parallelFor(50, [&](size_t i) {
+            writer.submit(i, to_string(i) + ";");
+        });
+    }
+
+    for (int i = 0; i < 50; i++) {
+        expectedOutput += to_string(i) + ";";
+    }
+
+    assert(orderedOutput.str() == expectedOutput);
+
+    // PSA4
+    partition = Partition({3, 2, 1, 1, 1, 1, 1});
+    PartitionSearchAlgorithm chainSearch(partition, 2, true);
+    actualPartitions = *chainSearch.getPartitions();
+    actualDistances = *chainSearch.getDistances();
+
+    for (int i = 0; i < actualPartitions.size(); i++) {
+        deque<Partition> partitionChain = *chainSearch.getChainPtr(i);
+
+        assert(partitionChain.front() == partition);
+        assert(partitionChain.back() == actualPartitions[i]);
+        assert(partitionChain.size() == actualDistances[i] + 1);
+
+        Partition replayed(partition);
+        TransitionChain transitionChain = *chainSearch.getTransitionChainPtr(i);
+        transitionChain.apply(replayed);
+
+        assert(transitionChain.length() == actualDistances[i]);
+        assert(replayed == actualPartitions[i]);
+    }
+
+    PartitionNodeStore nodeStore(partition, 2);
+    uint32_t node = PartitionNodeStore::ROOT;
+    deque<Partition> deepestChain = *chainSearch.getChainPtr(actualPartitions.size() - 1);
+
+    for (int i = 1; i < deepestChain.size(); i++) {
+        node = nodeStore.add(node, deepestChain[i - 1], deepestChain[i]);
+
+        assert(nodeStore.partition(node) == deepestChain[i]);
+    }
+
+    assert(deepestChain.size() > 2);
+    assert(*nodeStore.partitionChainPtr(node) == deepestChain);
+
+    bool thrown = false;
+
+    try {
+        serialSearch.getChainPtr(0);
+    }
+    catch (logic_error& error) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    // PSA5
+    ExternalPartitionSearchAlgorithm externalSearch(
+            Partition::from(14, 1), ExternalPartitionSearchAlgorithm::defaultDirectory(), 256
+    );
+    expectedPartitions = *serialSearch.getPartitions();
+    expectedDistances = *serialSearch.getDistances();
+    actualPartitions = *externalSearch.getPartitions();
+    actualDistances = *externalSearch.getDistances();
+
+    assert(actualPartitions.size() == expectedPartitions.size());
+    assert(externalSearch.getStatistics().visitedCount == serialSearch.getStatistics().visitedCount);
+
+    for (int i = 0; i < expectedPartitions.size(); i++) {
+        auto found = find(actualPartitions.begin(), actualPartitions.end(), expectedPartitions[i]);
+
+        assert(found != actualPartitions.end());
+        assert(actualDistances[found - actualPartitions.begin()] == expectedDistances[i]);
+    }
+
+    // Many runs per level merged two at a time
+    ExternalPartitionSearchAlgorithm narrowSearch(
+            Partition::from(14, 1), ExternalPartitionSearchAlgorithm::defaultDirectory(), 64, 2
+    );
+
+    assert(*narrowSearch.getPartitions() == actualPartitions);
+    assert(*narrowSearch.getDistances() == actualDistances);
+    assert(narrowSearch.getStatistics().visitedCount == externalSearch.getStatistics().visitedCount);
+
+    // Temporary files go away with their owner, on exceptions too
+    string keptPath, removedPath;
+
+    try {
+        TemporaryFiles files(ExternalPartitionSearchAlgorithm::defaultDirectory());
+        keptPath = files.create();
+        removedPath = files.create();
+
+        assert(keptPath != removedPath);
+        assert(ifstream(keptPath).good());
+
+        files.remove(removedPath);
+
+        assert(!ifstream(removedPath).good());
+
+        throw runtime_error("Failed search.");
+    }
+    catch (const runtime_error&) {
+    }
+
+    assert(!ifstream(keptPath).good());
+
+    // PSA6
+    SortedPartitionSearchAlgorithm sortedSearch(Partition::from(14, 1), 3);
+
+    assert(*sortedSearch.getPartitions() == actualPartitions);
+    assert(*sortedSearch.getDistances() == actualDistances);
+    assert(sortedSearch.getStatistics().visitedCount == serialSearch.getStatistics().visitedCount);
+    assert(sortedSearch.getStatistics().peakFrontierSize == serialSearch.getStatistics().peakFrontierSize);
+
+    // SE1: the level engine over graphical ascendants reaches the same maximums as over basic ones
+    ThreadPool enginePool(2);
+    vector<Partition> enginePartitions;
+    vector<int> engineDistances;
+    DistanceRecorder engineRecorder({enginePartitions, engineDistances});
+    levelSearch<GraphicalAscendants, MaximumGraphicalGoal<false>>(Partition::from(14, 1), enginePool, engineRecorder);
+
+    assert(enginePartitions.size() == actualPartitions.size());
+    assert(is_sorted(engineDistances.begin(), engineDistances.end()));
+
+    for (const auto& maximum: enginePartitions) {
+        assert(find(actualPartitions.begin(), actualPartitions.end(), maximum) != actualPartitions.end());
+    }
+
+    // SE2: streamed and visited results come in the order of PartitionSearchAlgorithm
+    MaximumGraphicalPartitionStream maximumStream(Partition::from(14, 1), 2);
+    Partition streamed(partition);
+    int streamedDistance;
+    size_t streamedCount = 0;
+
+    while (maximumStream.next(streamed, streamedDistance)) {
+        assert(streamed == expectedPartitions[streamedCount] && streamedDistance == expectedDistances[streamedCount]);
+        streamedCount++;
+    }
+
+    assert(streamedCount == expectedPartitions.size());
+    assert(maximumStream.getStatistics().visitedCount == serialSearch.getStatistics().visitedCount);
+
+    size_t visitedCount = forEachMaximumGraphicalPartition(Partition::from(14, 1), [&](const Partition& maximum, int distance) {
+        assert(maximum == expectedPartitions[0] && distance == expectedDistances[0]);
+
+        return false;
+    });
+
+    assert(visitedCount == 1);
+
+    MaximumGraphicalPartitionStream firstOnly(Partition::from(14, 1));
+    firstOnly.next(streamed, streamedDistance);
+
+    assert(firstOnly.getStatistics().visitedCount < serialSearch.getStatistics().visitedCount);
+
+    // SE3: a failing worker stops the unordered search instead of leaving the others waiting
+    ThreadPool failingPool(4);
+    vector<vector<Partition>> failingFound;
+    bool failedSearch = false;
+
+    try {
+        unorderedSearch<FailingAscendants, MaximumGraphicalGoal<false>>(Partition::from(24, 1), failingPool, failingFound);
+    }
+    catch (const runtime_error&) {
+        failedSearch = true;
+    }
+
+    assert(failedSearch);
+
+    // LS1
+    vector<Partition> allPartitions;
+    PartitionEnumerator enumerator(12);
+
+    while (enumerator.next(partition)) {
+        assert(allPartitions.empty() || allPartitions.back() != partition);
+        allPartitions.push_back(partition);
+    }
+
+    assert(allPartitions.size() == 77);
+    assert(allPartitions.front() == Partition({12}));
+    assert(allPartitions.back() == Partition::from(12, 1));
+
+    vector<Partition> graphicalPartitions;
+
+    for (auto& range: PartitionEnumerator(12, true).split(3)) {
+        while (range.next(partition)) {
+            graphicalPartitions.push_back(partition);
+        }
+    }
+
+    for (const auto& candidate: allPartitions) {
+        if (candidate.isGraphical()) {
+            assert(find(graphicalPartitions.begin(), graphicalPartitions.end(), candidate) != graphicalPartitions.end());
+        }
+    }
+
+    assert(all_of(graphicalPartitions.begin(), graphicalPartitions.end(), [](const Partition& p) {
+        return p.isGraphical();
+    }));
+
+    LatticeSweepAlgorithm latticeSweep(12, 2);
+    vector<Partition> sweptPartitions = *latticeSweep.getPartitions();
+    vector<unsigned int> reachableCounts = *latticeSweep.getReachableCounts();
+    vector<int> minDistances = *latticeSweep.getMinDistances();
+    vector<int> maxDistances = *latticeSweep.getMaxDistances();
+
+    assert(sweptPartitions.size() == graphicalPartitions.size());
+
+    for (int i = 0; i < sweptPartitions.size(); i++) {
+        PartitionSearchAlgorithm sweepCheck(sweptPartitions[i]);
+        vector<int> checkDistances = *sweepCheck.getDistances();
+
+        assert(reachableCounts[i] == checkDistances.size());
+        assert(minDistances[i] == *min_element(checkDistances.begin(), checkDistances.end()));
+        assert(maxDistances[i] == *max_element(checkDistances.begin(), checkDistances.end()));
+    }
+
     //endregion
 }
+
+void LimitGraphTest::serialization() {
+    stringstream stream;
+    BinaryWriter writer(stream);
+
+    Partition partition({7, 5, 5, 4, 1});
+    deque<Partition> partitionChain = *findShortestMaximizingChainPtr(Partition::from(10, 1));
+    TransitionChain chain({
+                                  new PartitionMove(1, 1, 0, 2),
+                                  new PartitionInsert(0, 3),
+                                  new PartitionRemove(0, 4)
+                          });
+
+    writer.write(partition);
+    writer.write(Partition({}));
+    writer.write(partitionChain);
+    writer.write(chain);
+    writer.write(deque<Partition>());
+
+    BinaryReader reader(stream);
+
+    assert(reader.next() == PARTITION_RECORD);
+    assert(reader.readPartition() == partition);
+    assert(reader.readPartition() == Partition({}));
+    assert(reader.next() == SEQUENCE_RECORD);
+    assert(reader.readSequence() == partitionChain);
+    assert(reader.next() == CHAIN_RECORD);
+    assert(reader.readChain() == chain);
+    assert(reader.readSequence().empty());
+    assert(reader.next() == END_OF_STREAM);
+
+    bool thrown = false;
+    stringstream invalidStream("LGPB");
+
+    try {
+        BinaryReader invalidReader(invalidStream);
+    }
+    catch (runtime_error& error) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    // A corrupt partition length or changed column is rejected instead of allocated
+    for (const string& corruptRecord: {
+            string("\x01\x80\x80\x80\x80\x08\x01", 7),
+            string("\x02\x02\x01\x01\x01\x80\x80\x80\x80\x08\x02", 11)
+    }) {
+        stringstream corruptStream(string("LGPB\x01") + corruptRecord);
+        BinaryReader corruptReader(corruptStream);
+        thrown = false;
+
+        try {
+            corruptRecord[0] == PARTITION_RECORD ? corruptReader.readPartition() : corruptReader.readSequence().back();
+        }
+        catch (runtime_error& error) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+
+    SearchResult result = {7, Partition({3, 2, 1, 1, 1}), {Partition({3, 3, 2}), Partition({4, 2, 1, 1})}, {2, 3}};
+    ResultFormatter binaryFormatter(BINARY_FORMAT);
+    stringstream resultStream(binaryFormatter.header() + binaryFormatter.format(result));
+    BinaryReader resultReader(resultStream);
+
+    assert(resultReader.next() == RESULT_RECORD);
+
+    SearchResult readResult = resultReader.readResult();
+
+    assert(readResult.query == result.query);
+    assert(readResult.start == result.start);
+    assert(readResult.partitions == result.partitions);
+    assert(readResult.distances == result.distances);
+    assert(ResultFormatter(CSV_FORMAT).format(result) == "7,2,2,3,3,2\n7,2,3,4,2,1,1\n");
+
+    // Binary stats are readable from the first byte on
+    stringstream statStream;
+    LimitGraphSession statSession(2);
+    statSession.writePartitionStats(statStream, 8, 3, 4, binaryFormatter);
+    BinaryReader statReader(statStream);
+
+    for (uint64_t i = 0; i < 4; i++) {
+        assert(statReader.next() == RESULT_RECORD);
+
+        SearchResult statResult = statReader.readResult();
+
+        assert(statResult.query == i);
+        assert(statResult.partitions.size() == statResult.distances.size());
+        assert(*PartitionSearchAlgorithm(statResult.start).getPartitions() == statResult.partitions);
+    }
+
+    assert(statReader.next() == END_OF_STREAM);
+
+    vector<unsigned int> queryValues;
+
+    assert(parsePartitionQuery(" 3 2\t2 1 ", queryValues) && queryValues == vector<unsigned int>({3, 2, 2, 1}));
+
+    for (const string& badQuery: {"2 2 2 -5", "2 2 2 0", "1 1 99999999999", "2 2x", "2 +2", "", "   "}) {
+        queryValues.clear();
+        assert(!parsePartitionQuery(badQuery, queryValues));
+    }
+
+    stringstream asyncOutput;
+    string expectedOutput;
+
+    {
+        AsyncOutputBuffer buffer(asyncOutput, 7);
+        ostream output(&buffer);
+
+        for (int i = 0; i < 1000; i++) {
+            output << i << "," << i * i << endl;
+            expectedOutput += to_string(i) + "," + to_string(i * i) + "\n";
+        }
+    }
+
+    assert(asyncOutput.str() == expectedOutput);
+
+    PartitionCodec codec(70);
+    vector<uint64_t> first(codec.words());
+    vector<uint64_t> second(codec.words());
+    partition = Partition({20, 20, 10, 5, 5, 3, 3, 1, 1, 1, 1});
+
+    codec.encode(partition, first.data());
+    codec.encode(Partition::from(70, 1), second.data());
+
+    assert(codec.words() == 2);
+    assert(codec.decode(first.data()) == partition);
+    assert(codec.decode(second.data()) == Partition::from(70, 1));
+    assert(!codec.equal(first.data(), second.data()));
+    assert(codec.less(first.data(), second.data()) != codec.less(second.data(), first.data()));
+
+    vector<uint64_t> records(second);
+    records.insert(records.end(), first.begin(), first.end());
+    records.insert(records.end(), second.begin(), second.end());
+    sortUniquePacked(codec, records);
+
+    assert(records.size() == 2 * codec.words());
+    assert(codec.less(&records[0], &records[codec.words()]));
+
+    subtractPacked(codec, records, first);
+
+    assert(records.size() == codec.words());
+}
+
 //TODO: Replace commented prints with logger
 
 ostream& operator<<(ostream& strm, vector<int> numbers) {
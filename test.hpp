@@ -10,6 +10,12 @@
 #include "partition.hpp"
 #include "transition.hpp"
 #include "algorithm.hpp"
+#include "serialization.hpp"
+#include "output.hpp"
+#include "packed.hpp"
+#include "external.hpp"
+#include "limit_graph.hpp"
+#include "search.hpp"
 
 class LimitGraphTest
 {
@@ -23,6 +29,8 @@ public:
     static void transition();
 
     static void algorithm();
+
+    static void serialization();
 };
 
 ostream &operator<<(ostream &strm, vector<int> numbers);
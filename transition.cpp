@@ -26,6 +26,10 @@ void PartitionInsert::apply(ColoredPartition& cpartition) {
     cpartition.insert(columnIndex);
 }
 
+void PartitionInsert::apply(PartitionBatch& batch) {
+    batch.insert(columnIndex);
+}
+
 unique_ptr<PartitionTransition> PartitionInsert::inverse() {
     return unique_ptr<PartitionTransition>(new PartitionRemove(columnIndex, rowIndex));
 }
@@ -120,6 +124,10 @@ void PartitionMove::apply(ColoredPartition& cpartition) {
     cpartition.move(fromColumn, toColumn);
 }
 
+void PartitionMove::apply(PartitionBatch& batch) {
+    batch.move(fromColumn, toColumn);
+}
+
 unique_ptr<PartitionTransition> PartitionMove::inverse() {
     return unique_ptr<PartitionTransition>(new PartitionMove(toColumn, toRow, fromColumn, fromRow));
 }
@@ -202,6 +210,10 @@ void PartitionRemove::apply(ColoredPartition& cpartition) {
     cpartition.remove(columnIndex);
 }
 
+void PartitionRemove::apply(PartitionBatch& batch) {
+    batch.remove(columnIndex);
+}
+
 unique_ptr<PartitionTransition> PartitionRemove::inverse() {
     return unique_ptr<PartitionTransition>(new PartitionInsert(columnIndex, rowIndex));
 }
@@ -331,6 +343,18 @@ void TransitionChain::apply(Partition& partition) {
     }
 }
 
+void TransitionChain::apply(PartitionBatch& batch) {
+    for (auto it = transitionPtrs.begin(); it != transitionPtrs.end(); ++it) {
+        (*it)->apply(batch);
+    }
+
+    if (!batch.isValid()) {
+        stringstream message;
+        message << "Transition chain " << toString() << " produced invalid partitions.";
+        throw runtime_error(message.str());
+    }
+}
+
 int TransitionChain::length() {
     return transitionPtrs.size();
 }
@@ -11,6 +11,8 @@ public:
 
     virtual void apply(ColoredPartition& partition) = 0;
 
+    virtual void apply(PartitionBatch& batch) = 0;
+
     virtual unique_ptr<PartitionTransition> inverse() = 0;
 
     virtual unique_ptr<PartitionTransition> conjugate() = 0;
@@ -55,6 +57,8 @@ public:
 
     void apply(ColoredPartition& cpartition);
 
+    void apply(PartitionBatch& batch);
+
     unique_ptr<PartitionTransition> inverse();
 
     unique_ptr<PartitionTransition> conjugate();
@@ -97,6 +101,8 @@ public:
 
     void apply(ColoredPartition& cpartition);
 
+    void apply(PartitionBatch& batch);
+
     unique_ptr<PartitionTransition> inverse();
 
     unique_ptr<PartitionTransition> conjugate();
@@ -139,6 +145,8 @@ public:
 
     void apply(ColoredPartition& cpartition);
 
+    void apply(PartitionBatch& batch);
+
     unique_ptr<PartitionTransition> inverse();
 
     unique_ptr<PartitionTransition> conjugate();
@@ -189,6 +197,8 @@ public:
 
     void apply(Partition& partition);
 
+    void apply(PartitionBatch& batch);
+
     int length();
 
     const PartitionTransition& operator[](int index);